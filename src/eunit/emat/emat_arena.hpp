@@ -0,0 +1,196 @@
+/*****************************************************************//**
+ *      @file  emat_arena.h
+ *      @brief Provide bump (arena) allocator for short-lived buffers
+ *
+ *  Detail Decsription starts here
+ *  [Example]:
+ *  s_arena arena;
+ *  s_arena_mat_allocator arena_allocator(&arena);
+ *  {
+ *  	s_arena::s_scope scope(arena);				//everything allocated in this scope is released at its end
+ *  	auto p_xos = arena.alloc_arr<int>(w);
+ *  	Mat tmp;
+ *  	tmp.allocator = &arena_allocator;			//data of tmp comes from arena
+ *  	resize(src, tmp, Size(64, 64));
+ *  }
+ *   @internal
+ *     Project
+ *     Created  10/19/2026
+ *    Revision  10/19/2026
+ *     Company
+ *   Copyright
+ *
+ * *******************************************************************/
+
+#ifndef EMAT_ARENA_H_
+#define EMAT_ARENA_H_
+
+#include "emat_core.hpp"
+#include <memory>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+namespace emat {
+	/*
+	bump allocator: allocations are released all together by rewinding to a mark,
+	after warm-up (the block grew to the peak usage) no call to the global allocator is made
+	*/
+	class s_arena {
+	private:
+		unique_ptr<u8[]> m_block;
+		size_t m_block_size = 0;
+		size_t m_offset = 0;
+		vector<unique_ptr<u8[]>> m_overflow;	//blocks allocated when m_block was full, merged into m_block on rewind
+		size_t m_overflow_size = 0;
+
+	public:
+		/*
+		release everything allocated during lifetime of scope
+		*/
+		class s_scope {
+		private:
+			s_arena& m_arena;
+			size_t m_mark;
+		public:
+			s_scope(s_arena& arena) : m_arena(arena), m_mark(arena.mark()) {}
+			~s_scope() {
+				m_arena.rewind(m_mark);
+			}
+		};
+
+		s_arena(const size_t& block_size = 0) {
+			reserve(block_size);
+		}
+
+		/**
+		reserve memory (only when arena is empty)
+		**/
+		inline void reserve(const size_t& block_size) {
+			if (m_offset == 0 && m_overflow.size() == 0 && block_size > m_block_size) {
+				m_block = unique_ptr<u8[]>(new u8[block_size]);
+				m_block_size = block_size;
+			}
+		}
+
+		/**
+		allocate memory
+		@param size [in] count of bytes
+		@param align [in] alignment (power of 2)
+		@return
+		**/
+		inline void* alloc(const size_t& size, const size_t& align = 64) {
+			size_t offset = (m_offset + align - 1) & ~(align - 1);
+			if (m_block && offset + size <= m_block_size) {
+				m_offset = offset + size;
+				return m_block.get() + offset;
+			}
+			//block is full: serve from an overflow block, the block grows on next rewind to the start
+			m_overflow.emplace_back(unique_ptr<u8[]>(new u8[size + align]));
+			m_overflow_size += size + align;
+			auto p = (size_t)m_overflow.back().get();
+			return (void*)((p + align - 1) & ~(align - 1));
+		}
+
+		/**
+		allocate array
+		**/
+		template<typename T_Res>
+		inline T_Res* alloc_arr(const size_t& cnt) {
+			return (T_Res*)alloc(cnt * sizeof(T_Res), max((size_t)64, alignof(T_Res)));
+		}
+
+		/**
+		get current position
+		**/
+		inline size_t mark() const {
+			return m_offset;
+		}
+
+		/**
+		release all allocations made after mark
+		**/
+		inline void rewind(const size_t& mark) {
+			m_offset = min(mark, m_offset);
+			if (m_offset == 0 && m_overflow.size() > 0) {
+				//merge into a single block which fits the peak usage
+				size_t block_size = m_block_size + m_overflow_size;
+				m_overflow.clear();
+				m_overflow_size = 0;
+				m_block = unique_ptr<u8[]>(new u8[block_size]);
+				m_block_size = block_size;
+			}
+		}
+
+		/**
+		get capacity (bytes)
+		**/
+		inline size_t capacity() const {
+			return m_block_size + m_overflow_size;
+		}
+
+		/**
+		release all memory (only when arena is empty)
+		**/
+		inline void shrink() {
+			if (m_offset == 0 && m_overflow.size() == 0) {
+				m_block.reset();
+				m_block_size = 0;
+			}
+		}
+	};
+
+	/*
+	cv::MatAllocator adapter: data of mats whose "allocator" is set to this comes from an arena,
+	mats must be released before the arena is rewound
+	*/
+	class s_arena_mat_allocator : public MatAllocator {
+	private:
+		s_arena* m_arena;
+#if CV_VERSION_MAJOR >= 4
+		typedef AccessFlag t_access_flag;
+#else
+		typedef int t_access_flag;
+#endif
+
+	public:
+		s_arena_mat_allocator(s_arena* arena) : m_arena(arena) {}
+
+		UMatData* allocate(int dims, const int* sizes, int type, void* data0, size_t* step, t_access_flag /*flags*/, UMatUsageFlags /*usageFlags*/) const {
+			size_t total = CV_ELEM_SIZE(type);
+			for (int i = dims - 1; i >= 0; i--) {
+				if (step) {
+					if (data0 && step[i] != 0 && step[i] != (size_t)0x7fffffff) {	//0x7fffffff: CV_AUTOSTEP
+						assert(total <= step[i]);
+						total = step[i];
+					}
+					else {
+						step[i] = total;
+					}
+				}
+				total *= sizes[i];
+			}
+			u8* data = data0 ? (u8*)data0 : (u8*)m_arena->alloc(total);
+			UMatData* u = new (m_arena->alloc(sizeof(UMatData), alignof(UMatData))) UMatData(this);
+			u->data = u->origdata = data;
+			u->size = total;
+			if (data0) {
+				u->flags |= UMatData::USER_ALLOCATED;
+			}
+			return u;
+		}
+
+		bool allocate(UMatData* u, t_access_flag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const {
+			return u != 0;
+		}
+
+		void deallocate(UMatData* u) const {
+			if (u && u->refcount == 0) {
+				//memory is given back when the arena is rewound
+				u->~UMatData();
+			}
+		}
+	};
+}
+#endif
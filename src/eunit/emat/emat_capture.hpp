@@ -0,0 +1,256 @@
+/*****************************************************************//**
+ *      @file  emat_capture.h
+ *      @brief Provide background capture (grab thread + ring of preallocated frames)
+ *
+ *  Detail Decsription starts here
+ *  [Example]:
+ *  s_capture capture(4, s_capture::policy_drop_oldest);
+ *  capture.start(0);										//grab from device 0 on a background thread
+ *  const s_capture::s_frame* frame;
+ *  while (capture.retrieve(frame, 1000)) {				//previous frame is given back to the ring
+ *  	viewer.img_show_cache_shared(win_name, frame->mat.size(), frame->mat, frame->mat, texts);	//no copy
+ *  	viewer.imgs_show(false);
+ *  	waitKey(1);
+ *  }
+ *   @internal
+ *     Project
+ *     Created  10/19/2026
+ *    Revision  10/19/2026
+ *     Company
+ *   Copyright
+ *
+ * *******************************************************************/
+
+#ifndef EMAT_CAPTURE_H_
+#define EMAT_CAPTURE_H_
+
+#include "emat_core.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <chrono>
+
+using namespace std;
+
+namespace emat {
+	/*
+	background capture: a grab thread fills a bounded ring of frames, the consumer takes them in order,
+	buffers of frames are reused unless they are still referenced elsewhere (e.g. shared with viewer), so handoff needs no copy
+	*/
+	class s_capture {
+	public:
+		enum e_policy {
+			policy_drop_oldest,		//ring full: oldest frame not taken yet is overwritten (acquisition never waits)
+			policy_block,			//ring full: grab thread waits for the consumer (no frame is lost)
+		};
+
+		class s_frame {
+		public:
+			Mat mat;
+			u64 idx = 0;			//index of grabbed frame (gaps mean dropped frames)
+			double timestamp = 0.;	//time when grab finished (ms, steady clock)
+		};
+
+	private:
+		vector<s_frame> m_slots;
+		deque<int> m_free;
+		deque<int> m_filled;
+		int m_held = -1;			//slot held by the consumer (between two retrieve)
+		e_policy m_policy;
+		mutex m_lock;
+		condition_variable m_cond;
+		thread m_thread;
+		bool m_running = false;
+		bool m_finished = false;
+		VideoCapture m_capture;
+		u64 m_grabbed = 0;
+		u64 m_dropped = 0;
+
+		static inline double now_ms() {
+			return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		/**
+		loop of grab thread
+		**/
+		inline void run(function<bool(Mat&)> source) {
+			while (true) {
+				int slot = -1;
+				{
+					unique_lock<mutex> lock_(m_lock);
+					if (m_policy == policy_block) {
+						m_cond.wait(lock_, [&] { return !m_running || m_free.size() > 0; });
+					}
+					if (!m_running) break;
+					if (m_free.size() > 0) {
+						slot = m_free.front();
+						m_free.pop_front();
+					}
+					else if (m_filled.size() > 0) {
+						slot = m_filled.front();
+						m_filled.pop_front();
+						++m_dropped;
+					}
+					else {
+						//ring of a single slot which is held by the consumer
+						lock_.unlock();
+						this_thread::yield();
+						continue;
+					}
+				}
+				auto& frame = m_slots[slot];
+				if (frame.mat.u && frame.mat.u->refcount > 1) {
+					//buffer is still referenced (e.g. displayed by viewer): detach instead of overwriting
+					frame.mat.release();
+				}
+				bool ok = source(frame.mat) && !frame.mat.empty();
+				lock_guard<mutex> lock_(m_lock);
+				if (ok) {
+					frame.idx = m_grabbed++;
+					frame.timestamp = now_ms();
+					m_filled.push_back(slot);
+				}
+				else {
+					m_free.push_back(slot);
+					m_finished = true;
+					m_running = false;
+				}
+				m_cond.notify_all();
+			}
+		}
+
+	public:
+		/**
+		create capture
+		@param ring_size [in] count of frames in ring (>= 2, 1 frame is held by the consumer)
+		@param policy [in] behavior when ring is full
+		@return
+		**/
+		s_capture(const int& ring_size = 4, const e_policy& policy = policy_drop_oldest)
+			: m_slots(max(ring_size, 2)), m_policy(policy) {
+		}
+
+		~s_capture() {
+			stop();
+		}
+
+		/**
+		start grab thread with a frame source
+		@param source [in] fills the given mat (reuse its buffer if possible), false: end of stream
+		@return
+		**/
+		inline bool start(function<bool(Mat&)> source) {
+			stop();
+			lock_guard<mutex> lock_(m_lock);
+			m_free.clear();
+			m_filled.clear();
+			for (int i = 0; i < (int)m_slots.size(); ++i) {
+				m_free.push_back(i);
+			}
+			m_held = -1;
+			m_running = true;
+			m_finished = false;
+			m_thread = thread(&s_capture::run, this, source);
+			return true;
+		}
+
+		/**
+		start grab thread on a camera
+		**/
+		inline bool start(const int& device) {
+			stop();
+			if (!m_capture.open(device)) return false;
+			return start([this](Mat& mat) { return m_capture.read(mat); });
+		}
+
+		/**
+		start grab thread on a video file / stream
+		**/
+		inline bool start(const string& file_name) {
+			stop();
+			if (!m_capture.open(file_name)) return false;
+			return start([this](Mat& mat) { return m_capture.read(mat); });
+		}
+
+		/**
+		stop grab thread
+		**/
+		inline void stop() {
+			{
+				lock_guard<mutex> lock_(m_lock);
+				m_running = false;
+				m_cond.notify_all();
+			}
+			if (m_thread.joinable()) {
+				m_thread.join();
+			}
+		}
+
+		/**
+		take the oldest grabbed frame, the previously retrieved frame is given back to the ring
+		(its mat stays valid as long as it is referenced, e.g. by viewer)
+		@param frame [out] frame (valid until next retrieve)
+		@param timeout_ms [in] max waiting time (< 0: infinite)
+		@return false if timed out or stream ended
+		**/
+		inline bool retrieve(const s_frame*& frame, const int& timeout_ms = -1) {
+			unique_lock<mutex> lock_(m_lock);
+			if (m_held >= 0) {
+				m_free.push_back(m_held);
+				m_held = -1;
+				m_cond.notify_all();
+			}
+			auto ready = [&] { return m_filled.size() > 0 || !m_running; };
+			if (timeout_ms < 0) {
+				m_cond.wait(lock_, ready);
+			}
+			else {
+				m_cond.wait_for(lock_, chrono::milliseconds(timeout_ms), ready);
+			}
+			if (m_filled.size() == 0) {
+				frame = 0;
+				return false;
+			}
+			m_held = m_filled.front();
+			m_filled.pop_front();
+			frame = &m_slots[m_held];
+			return true;
+		}
+
+		/**
+		count of grabbed frames
+		**/
+		inline u64 grabbed() {
+			lock_guard<mutex> lock_(m_lock);
+			return m_grabbed;
+		}
+
+		/**
+		count of frames overwritten before being retrieved (policy_drop_oldest)
+		**/
+		inline u64 dropped() {
+			lock_guard<mutex> lock_(m_lock);
+			return m_dropped;
+		}
+
+		/**
+		count of frames waiting in ring
+		**/
+		inline int pending() {
+			lock_guard<mutex> lock_(m_lock);
+			return (int)m_filled.size();
+		}
+
+		/**
+		whether the source reported end of stream
+		**/
+		inline bool finished() {
+			lock_guard<mutex> lock_(m_lock);
+			return m_finished;
+		}
+	};
+}
+#endif
@@ -18,6 +18,8 @@
 
 #include <opencv2/opencv.hpp>
 #include <typeinfo>
+#include <type_traits>
+#include <vector>
 
 using namespace cv;
 
@@ -52,58 +54,107 @@ namespace emat {
 		}
 	};
 
+	/**
+	compile-time mapping of c++ type to cv depth / channels / type (-1 if there is no corresponding cv type)
+	**/
+	template<typename T_Src>
+	struct cv_type_traits {
+		static const int depth = -1;
+		static const int channels = 0;
+		static const int type = -1;
+	};
+
+#define emat_cv_type_traits(t, d) \
+	template<> struct cv_type_traits<t> { static const int depth = d; static const int channels = 1; static const int type = CV_MAKETYPE(d, 1); };
+	emat_cv_type_traits(u8, CV_8U)
+	emat_cv_type_traits(i8, CV_8S)
+	emat_cv_type_traits(u16, CV_16U)
+	emat_cv_type_traits(i16, CV_16S)
+	emat_cv_type_traits(i32, CV_32S)
+	emat_cv_type_traits(float, CV_32F)
+	emat_cv_type_traits(double, CV_64F)
+#undef emat_cv_type_traits
+
+	template<typename T_Src, int T_Cn>
+	struct cv_type_traits<Vec<T_Src, T_Cn>> {
+		static const int depth = cv_type_traits<T_Src>::depth;
+		static const int channels = (depth < 0 || T_Cn > 4) ? 0 : T_Cn;
+		static const int type = channels ? CV_MAKETYPE(depth, channels) : -1;
+	};
+
+	template<typename T_Src>
+	struct cv_type_traits<Point_<T_Src>> : cv_type_traits<Vec<T_Src, 2>> {};
+
+	template<typename T_Src>
+	struct cv_type_traits<Point3_<T_Src>> : cv_type_traits<Vec<T_Src, 3>> {};
+
+	/**
+	compile-time mapping of cv depth to c++ type
+	**/
+	template<int T_Depth> struct cv_depth_type {};
+	template<> struct cv_depth_type<CV_8U> { typedef u8 type; };
+	template<> struct cv_depth_type<CV_8S> { typedef i8 type; };
+	template<> struct cv_depth_type<CV_16U> { typedef u16 type; };
+	template<> struct cv_depth_type<CV_16S> { typedef i16 type; };
+	template<> struct cv_depth_type<CV_32S> { typedef i32 type; };
+	template<> struct cv_depth_type<CV_32F> { typedef float type; };
+	template<> struct cv_depth_type<CV_64F> { typedef double type; };
+
+	/**
+	compile-time mapping of cv type to c++ type (scalar for single channel, Vec otherwise)
+	**/
+	template<int T_Type>
+	struct cv_to_sys_type {
+		typedef typename cv_depth_type<CV_MAT_DEPTH(T_Type)>::type depth_type;
+		typedef typename std::conditional<CV_MAT_CN(T_Type) == 1, depth_type, Vec<depth_type, CV_MAT_CN(T_Type)>>::type type;
+	};
+
 	/**
 	return corresponding cv type
 	**/
 	template<typename T_Src>
-	inline int sys_to_cv_type() {
-		if (is_same_type<T_Src, u8>()) return CV_8U;
-		else if (is_same_type<T_Src, u16>()) return CV_16U;
-		else if (is_same_type<T_Src, i8>()) return CV_8S;
-		else if (is_same_type<T_Src, i16>()) return CV_16S;
-		else if (is_same_type<T_Src, i32>()) return CV_32S;
-		else if (is_same_type<T_Src, float>()) return CV_32F;
-		else if (is_same_type<T_Src, double>()) return CV_64F;
-
-		else if (is_same_type<T_Src, Point2i>()) return CV_32SC2;
-		else if (is_same_type<T_Src, Point2f>()) return CV_32FC2;
-		else if (is_same_type<T_Src, Point2d>()) return CV_64FC2;
-		else if (is_same_type<T_Src, Point3i>()) return CV_32SC3;
-		else if (is_same_type<T_Src, Point3f>()) return CV_32FC3;
-		else if (is_same_type<T_Src, Point3d>()) return CV_64FC3;
-
-		else if (is_same_type<T_Src, Vec<u8, 2>>()) return CV_8UC2;
-		else if (is_same_type<T_Src, Vec<u16, 2>>()) return CV_16UC2;
-		else if (is_same_type<T_Src, Vec<i8, 2>>()) return CV_8SC2;
-		else if (is_same_type<T_Src, Vec<i16, 2>>()) return CV_16SC2;
-		else if (is_same_type<T_Src, Vec<i32, 2>>()) return CV_32SC2;
-		else if (is_same_type<T_Src, Vec<float, 2>>()) return CV_32FC2;
-		else if (is_same_type<T_Src, Vec<double, 2>>()) return CV_64FC2;
-
-		else if (is_same_type<T_Src, Vec<u8, 3>>()) return CV_8UC3;
-		else if (is_same_type<T_Src, Vec<u16, 3>>()) return CV_16UC3;
-		else if (is_same_type<T_Src, Vec<i8, 3>>()) return CV_8SC3;
-		else if (is_same_type<T_Src, Vec<i16, 3>>()) return CV_16SC3;
-		else if (is_same_type<T_Src, Vec<i32, 3>>()) return CV_32SC3;
-		else if (is_same_type<T_Src, Vec<float, 3>>()) return CV_32FC3;
-		else if (is_same_type<T_Src, Vec<double, 3>>()) return CV_64FC3;
-
-		else if (is_same_type<T_Src, Vec<u8, 4>>()) return CV_8UC4;
-		else if (is_same_type<T_Src, Vec<u16, 4>>()) return CV_16UC4;
-		else if (is_same_type<T_Src, Vec<i8, 4>>()) return CV_8SC4;
-		else if (is_same_type<T_Src, Vec<i16, 4>>()) return CV_16SC4;
-		else if (is_same_type<T_Src, Vec<i32, 4>>()) return CV_32SC4;
-		else if (is_same_type<T_Src, Vec<float, 4>>()) return CV_32FC4;
-		else if (is_same_type<T_Src, Vec<double, 4>>()) return CV_64FC4;
-		return -1;
+	inline constexpr int sys_to_cv_type() {
+		return cv_type_traits<T_Src>::type;
+	}
+
+	/**
+	whether cv depth is a floating point depth
+	**/
+	inline constexpr bool is_float_depth(const int depth) {
+		return depth == CV_32F || depth == CV_64F;
 	}
 
+	/**
+	count of cv depths supported by emat (CV_8U ... CV_64F)
+	**/
+	static const int emat_depth_cnt = CV_64F + 1;
+
+	/**
+	dispatch table: select T_Func<T>::run (instantiated for every depth) by cv depth, once per mat instead of once per element
+	T_Func<T>::run must have the same signature for all T
+	[Example]:
+	template<typename T> struct s_sum { static double run(const Mat& m) { ... } };
+	auto fn = depth_dispatch<s_sum>::get(mat.depth());
+	fn(mat);
+	**/
+	template<template<typename> class T_Func>
+	struct depth_dispatch {
+		typedef decltype(&T_Func<u8>::run) t_fn;
+		static inline t_fn get(const int& depth) {
+			static const t_fn fns[emat_depth_cnt] = {
+				&T_Func<u8>::run, &T_Func<i8>::run, &T_Func<u16>::run, &T_Func<i16>::run, &T_Func<i32>::run, &T_Func<float>::run, &T_Func<double>::run
+			};
+			assert(depth >= 0 && depth < emat_depth_cnt && "CV Type Error");
+			return fns[depth];
+		}
+	};
+
 	/**
 	check cv type
 	**/
 	template<typename T_res>
 	inline void type_check(const Mat& dst, const bool matched) {
-		assert(dst.isContinuous() && ((dst.type() == sys_to_cv_type<T_res>()) == matched) && "CV type check failed.");
+		assert(((dst.type() == sys_to_cv_type<T_res>()) == matched) && "CV type check failed.");
 	}
 
 	/**
@@ -117,15 +168,8 @@ namespace emat {
 	get sizeof of mat
 	**/
 	inline u32 size_of(const int type) {
-		if (type == CV_8UC1 || type == CV_8UC2 || type == CV_8UC3 || type == CV_8UC4) return sizeof(u8);
-		else if (type == CV_16UC1 || type == CV_16UC2 || type == CV_16UC3 || type == CV_16UC4) return sizeof(u16);
-		else if (type == CV_8SC1 || type == CV_8SC2 || type == CV_8SC3 || type == CV_8SC4) return sizeof(i8);
-		else if (type == CV_16SC1 || type == CV_16SC2 || type == CV_16SC3 || type == CV_16SC4) return sizeof(i16);
-		else if (type == CV_32SC1 || type == CV_32SC2 || type == CV_32SC3 || type == CV_32SC4) return sizeof(i32);
-		else if (type == CV_32FC1 || type == CV_32FC2 || type == CV_32FC3 || type == CV_32FC4) return sizeof(float);
-		else if (type == CV_64FC1 || type == CV_64FC2 || type == CV_64FC3 || type == CV_64FC4) return sizeof(double);
-		else assert("CV Type Error");
-		return 0;
+		assert(CV_MAT_DEPTH(type) < emat_depth_cnt && "CV Type Error");
+		return (u32)CV_ELEM_SIZE1(type);
 	}
 
 
@@ -137,16 +181,59 @@ namespace emat {
 	}
 
 	/**
-	return data pointer of a mat
+	split a N-D mat (dims >= 3, e.g. D x H x W or N x C x H x W) into 2D views of its last two dims (no copy),
+	views do not hold a reference of src (keep src alive while they are used)
+	@param src [in] N-D mat (a 2D mat gives a single view)
+	@param res [out] views in order of the leading dims
+	@return
+	**/
+	inline void nd_slices(const Mat& src, std::vector<Mat>& res) {
+		res.clear();
+		if (src.empty()) return;
+		if (src.dims <= 2) {
+			res.emplace_back(src);
+			return;
+		}
+		int dims = src.dims, cnt = 1;
+		for (int i = 0; i < dims - 2; ++i) {
+			cnt *= src.size[i];
+		}
+		res.reserve(cnt);
+		for (int i = 0; i < cnt; ++i) {
+			//offset of slice i (leading dims may be strided)
+			size_t offset = 0;
+			for (int d = dims - 3, idx = i; d >= 0; --d) {
+				offset += (size_t)(idx % src.size[d]) * src.step[d];
+				idx /= src.size[d];
+			}
+			res.emplace_back(src.size[dims - 2], src.size[dims - 1], src.type(), (void*)(src.data + offset), src.step[dims - 2]);
+		}
+	}
+
+	/**
+	return data pointer of a mat (linear access, mat must be continuous, see pointer(src_mat, y) for roi views)
 	**/
 	template<typename T_Src>
 	inline T_Src* pointer(const Mat& src_mat) {
 #if emat_security_protection_en
 		if ((u32)src_mat.total() > 0) {
 			type_check<T_Src>(src_mat, true);
+			assert(src_mat.isContinuous() && "Linear access of non-continuous mat, use pointer(src_mat, y).");
 		}
 #endif
 		return (T_Src*)src_mat.data;
 	}
+
+	/**
+	return pointer of row y of a mat (stride aware)
+	**/
+	template<typename T_Src>
+	inline T_Src* pointer(const Mat& src_mat, const int& y) {
+#if emat_security_protection_en
+		type_check<T_Src>(src_mat, true);
+		assert(y >= 0 && y < src_mat.rows);
+#endif
+		return (T_Src*)(src_mat.data + src_mat.step[0] * y);
+	}
 }
 #endif
\ No newline at end of file
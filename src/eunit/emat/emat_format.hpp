@@ -0,0 +1,210 @@
+/*****************************************************************//**
+ *      @file  emat_format.h
+ *      @brief Provide allocation-free formatting of mat values
+ *
+ *  Detail Decsription starts here
+ *  Example:
+ *  s_val_txt txt;
+ *  fmt_val(3.14159f, 2, txt);		// "3.14"
+ *  fmt_val(3.14159f, -1, txt);		// "3.14159" (shortest)
+ *  fmt_val(1.5e9, 2, txt);			// "1.50e9"
+ *   @internal
+ *     Project
+ *     Created  10/19/2026
+ *    Revision  10/19/2026
+ *     Company
+ *   Copyright
+ *
+ * *******************************************************************/
+
+#ifndef EMAT_FORMAT_H_
+#define EMAT_FORMAT_H_
+
+#include "emat_core.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+namespace emat {
+	/*
+	text of a single value (fixed capacity, never allocates)
+	*/
+	class s_val_txt {
+	public:
+		enum { capacity = 15 };
+		char txt[capacity];
+		u8 len = 0;
+
+		/**
+		convert to cv::String (fits in small string buffer, no heap allocation for std::string based cv::String)
+		**/
+		inline String str() const {
+			return String(txt, len);
+		}
+	};
+
+	/*
+	texts of all channels of a pixel
+	*/
+	class s_val_txts {
+	public:
+		enum { capacity = 4 };
+		s_val_txt txts[capacity];
+		u8 cnt = 0;
+
+		inline int size() const {
+			return cnt;
+		}
+
+		inline const s_val_txt& operator[](const int& idx) const {
+			return txts[idx];
+		}
+	};
+
+	/**
+	format integer value
+	**/
+	inline void fmt_int(const i64& v, s_val_txt& res) {
+		char buf[24];
+		int len = 0;
+		u64 u = v < 0 ? (u64)(-(v + 1)) + 1 : (u64)v;
+		do {
+			buf[len++] = (char)('0' + u % 10);
+			u /= 10;
+		} while (u > 0);
+		if (v < 0) {
+			buf[len++] = '-';
+		}
+		res.len = (u8)min(len, (int)s_val_txt::capacity);
+		for (int i = 0; i < res.len; ++i) {
+			res.txt[i] = buf[len - 1 - i];
+		}
+	}
+
+	/**
+	format integer value with a single character label, e.g. "R:512" (channel of a native sensor value)
+	**/
+	inline void fmt_int_labeled(const char& label, const i64& v, s_val_txt& res) {
+		fmt_int(v, res);
+		int len = min((int)res.len, (int)s_val_txt::capacity - 2);
+		memmove(res.txt + 2, res.txt, len);
+		res.txt[0] = label;
+		res.txt[1] = ':';
+		res.len = (u8)(len + 2);
+	}
+
+	/**
+	copy printf output into res, "e+07" / "e-07" style exponents are compacted into "e7" / "e-7"
+	**/
+	inline void fmt_compact(const char* buf, s_val_txt& res) {
+		int len = 0;
+		for (const char* p = buf; *p && len < (int)s_val_txt::capacity; ++p) {
+			res.txt[len++] = *p;
+			if (*p == 'e' || *p == 'E') {
+				++p;
+				if (*p == '-') {
+					res.txt[len++] = '-';
+					++p;
+				}
+				else if (*p == '+') {
+					++p;
+				}
+				while (*p == '0' && *(p + 1) != 0) ++p;
+				--p;
+			}
+		}
+		res.len = (u8)len;
+	}
+
+	/**
+	format floating point value
+	@param v [in] value
+	@param is_single [in] whether value is float (round trip check of shortest format)
+	@param precision [in] decimals (>= 0), or -1 for the shortest text (at most 7 significant digits) which reads back to the same value
+	@param res [out] text
+	@return
+	**/
+	inline void fmt_float(const double& v, const bool& is_single, const int& precision, s_val_txt& res) {
+		char buf[48];
+		if (v != v) {
+			fmt_compact("nan", res);
+			return;
+		}
+		if (v == numeric_limits<double>::infinity() || v == -numeric_limits<double>::infinity()) {
+			fmt_compact(v > 0 ? "inf" : "-inf", res);
+			return;
+		}
+		if (precision < 0) {
+			const int max_digits = 7;
+			for (int digits = 1; digits <= max_digits; ++digits) {
+				snprintf(buf, sizeof(buf), "%.*g", digits, v);
+				double v_read = strtod(buf, 0);
+				if (is_single ? ((float)v_read == (float)v) : (v_read == v)) break;
+			}
+		}
+		else if (fabs(v) < 1e6) {
+			snprintf(buf, sizeof(buf), "%.*f", min(precision, 7), v);
+		}
+		else {
+			//compact scientific fallback for large values
+			snprintf(buf, sizeof(buf), "%.*e", min(precision, 6), v);
+		}
+		fmt_compact(buf, res);
+	}
+
+	/**
+	format value of any cv depth
+	**/
+	template<typename T_Src>
+	inline void fmt_val(const T_Src& v, const int& precision, s_val_txt& res) {
+		if (std::is_floating_point<T_Src>::value) {
+			fmt_float((double)v, sizeof(T_Src) == sizeof(float), precision, res);
+		}
+		else {
+			fmt_int((i64)v, res);
+		}
+	}
+
+	/**
+	format text which is at least as wide as the text of any value in [v_min, v_max] (used to estimate size of cells)
+	@param depth [in] cv depth of values
+	@param v_min [in] min value
+	@param v_max [in] max value
+	@param precision [in] see fmt_float
+	@param res [out] text
+	@return
+	**/
+	inline void fmt_widest(const int& depth, const double& v_min, const double& v_max, const int& precision, s_val_txt& res) {
+		s_val_txt txt_min, txt_max, txt_extra;
+		if (is_float_depth(depth)) {
+			bool is_single = depth == CV_32F;
+			double v_abs = max(fabs(v_min), fabs(v_max));
+			if (precision < 0) {
+				//shortest text: assume all significant digits are used, small values are printed in scientific format
+				char buf[48];
+				snprintf(buf, sizeof(buf), "%#.7g", v_min < 0 ? -v_abs : v_abs);
+				fmt_compact(buf, txt_min);
+				fmt_float(v_min < 0 ? -1.234567e-10 : 1.234567e-10, is_single, -1, txt_max);
+			}
+			else {
+				fmt_float(v_min, is_single, precision, txt_min);
+				fmt_float(v_max, is_single, precision, txt_max);
+				if (v_abs >= 1e6) {
+					//values below 1e6 are printed in fixed format
+					fmt_float(v_min < 0 ? -999999.9 : 999999.9, is_single, precision, txt_extra);
+				}
+			}
+		}
+		else {
+			fmt_int((i64)v_min, txt_min);
+			fmt_int((i64)v_max, txt_max);
+		}
+		if (txt_extra.len > txt_min.len) {
+			txt_min = txt_extra;
+		}
+		res = txt_min.len >= txt_max.len ? txt_min : txt_max;
+	}
+}
+#endif
@@ -3,7 +3,10 @@
  *      @brief Provide mat initilization functions related to emat
  *
  *  Detail Decsription starts here
- *
+ *  [Example]:
+ *  Mat X = s_meshgrid_gen<float>(Range(0, 640), Range(0, 480)).x().mat();		//materialize on demand
+ *  s_vis_range range(s_vis_range::range_minmax);
+ *  vis_colorize(s_range_gen<float>(0.f, 1.f, Size(640, 480)), vis_colormap_lut(COLORMAP_JET), range, res);	//fused, no source mat
  *   @internal
  *     Project
  *     Created  1/7/2019
@@ -18,6 +21,9 @@
 
 #include "emat_core.hpp"
 #include "emat_omp.hpp"
+#include <vector>
+#include <limits>
+#include <type_traits>
 
 namespace emat {
 	/**
@@ -66,57 +72,280 @@ namespace emat {
 	}
 
 	/**
-	generate meshgrid
+	run func(y, p_row) on every row of a lazy generator (see s_range_gen), rows are generated into a per-thread buffer
+	(used to fuse generators into consuming kernels without materializing them)
 	**/
-	template<typename T_Src>
-	inline void meshgrid(const Range& xs, const Range& ys, Mat& X, Mat& Y) {
-		register i32 x_end = xs.end, x_start = xs.start,
-			y_end = ys.end, y_start = ys.start,
-			y_len = y_end - y_start,
-			x_len = x_end - x_start;
-		create<T_Src>(Size(x_len, y_len), X);
-		create<T_Src>(Size(x_len, y_len), Y);
+	template<typename T_Gen, typename T_Func>
+	inline void gen_for_each_row(const T_Gen& gen, T_Func func) {
+		typedef typename T_Gen::t_val T_Val;
+		register i32 rows = gen.size().height, cols = gen.size().width;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+		emat_omp{
+			std::vector<T_Val> buf(cols);
+			for (i32 y = emat_omp_offset_range(0, rows), y_end = emat_omp_offset_next_range(0, rows); y < y_end; ++y) {
+				gen.row(y, buf.data());
+				func(y, (const T_Val*)buf.data());
+			}
+		}
+	}
 
+	/**
+	exact min / max of a lazy generator by generating all of its rows (for generators whose extremes can not be derived, e.g. wrapped values)
+	@param gen [in] generator
+	@param res_min [out] min (0 if empty)
+	@param res_max [out] max (0 if empty)
+	@return
+	**/
+	template<typename T_Gen>
+	inline void gen_minmax_scan(const T_Gen& gen, double& res_min, double& res_max) {
+		typedef typename T_Gen::t_val T_Val;
+		register i32 rows = gen.size().height, cols = gen.size().width;
+		res_min = 0.;
+		res_max = 0.;
+		if (rows <= 0 || cols <= 0) return;
+		double mins[emat_omp_cnt], maxs[emat_omp_cnt];
+		for (i32 i = 0; i < emat_omp_cnt; ++i) {
+			mins[i] = std::numeric_limits<double>::max();
+			maxs[i] = std::numeric_limits<double>::lowest();
+		}
 #ifdef _OPENMP
 #pragma omp parallel for num_threads(emat_omp_cnt)
 #endif
 		emat_omp{
-			register auto y_offset = emat_omp_offset(y_len), y_offset_next = emat_omp_offset_next(y_len);
-			register auto p_x = (T_Src*)X.data + y_offset * x_len;
-			register auto p_y = (T_Src*)Y.data + y_offset * x_len;
-			register i32 y_start_omp = y_start + y_offset, y_end_omp = y_start + y_offset_next;
-			for (i32 y = y_start_omp, x = 0; y < y_end_omp; ++y) {
-				for (x = x_start; x < x_end; ++x) {
-					*p_x++ = (T_Src)x;
-					*p_y++ = (T_Src)y;
+			std::vector<T_Val> buf(cols);
+			double v_min = mins[emat_omp_idx], v_max = maxs[emat_omp_idx];
+			for (i32 y = emat_omp_offset_range(0, rows), y_end = emat_omp_offset_next_range(0, rows); y < y_end; ++y) {
+				gen.row(y, buf.data());
+				for (i32 x = 0; x < cols; ++x) {
+					v_min = std::min(v_min, (double)buf[x]);
+					v_max = std::max(v_max, (double)buf[x]);
 				}
 			}
+			mins[emat_omp_idx] = v_min;
+			maxs[emat_omp_idx] = v_max;
+		}
+		res_min = mins[0];
+		res_max = maxs[0];
+		for (i32 i = 1; i < emat_omp_cnt; ++i) {
+			res_min = std::min(res_min, mins[i]);
+			res_max = std::max(res_max, maxs[i]);
 		}
 	}
 
 	/**
-	generate range mat
+	materialize a lazy generator into a mat
 	**/
-	template<typename T_res>
-	inline void range(const T_res start, const T_res step, const Size& size, Mat& res)
-	{
-		create<T_res>(size, res);
-		register auto res_len = (u32)res.total();
+	template<typename T_Gen>
+	inline void gen_materialize(const T_Gen& gen, Mat& res) {
+		typedef typename T_Gen::t_val T_Val;
+		create<T_Val>(gen.size(), res);
+		register i32 rows = res.rows;
 #ifdef _OPENMP
 #pragma omp parallel for num_threads(emat_omp_cnt)
 #endif
 		emat_omp{
-			register auto res_offset = emat_omp_offset(res_len), res_offset_next = emat_omp_offset_next(res_len);
-			register auto p_res = (T_res*)res.data + res_offset;
-			register auto p_res_end = (T_res*)res.data + res_offset_next;
-			register auto v_start = (T_res)(start + step * res_offset);
-			while (p_res < p_res_end) {
-				*(p_res++) = v_start;
-				v_start += step;
+			for (i32 y = emat_omp_offset_range(0, rows), y_end = emat_omp_offset_next_range(0, rows); y < y_end; ++y) {
+				gen.row(y, res.ptr<T_Val>(y));
 			}
 		}
 	}
 
+	/*
+	lazy range: value at (y, x) is start + step * ((roi.y + y) * size.width + roi.x + x),
+	only the description is stored (O(1) memory), values are generated on demand
+	*/
+	template<typename T_res>
+	class s_range_gen {
+	public:
+		typedef T_res t_val;
+		T_res m_start;
+		T_res m_step;
+		Size m_size;
+		Rect m_roi;
+
+		s_range_gen(const T_res start, const T_res step, const Size& size)
+			: m_start(start), m_step(step), m_size(size), m_roi(0, 0, size.width, size.height) {}
+
+		s_range_gen(const T_res start, const T_res step, const Size& size, const Rect& ROI)
+			: m_start(start), m_step(step), m_size(size), m_roi(ROI) {}
+
+		inline Size size() const {
+			return m_roi.size();
+		}
+
+		inline T_res operator()(const i32& y, const i32& x) const {
+			return (T_res)(m_start + m_step * (T_res)((i64)(m_roi.y + y) * m_size.width + m_roi.x + x));
+		}
+
+		inline void row(const i32& y, T_res* res) const {
+			register T_res v = (*this)(y, 0);
+			for (i32 x = 0, x_end = m_roi.width; x < x_end; ++x) {
+				res[x] = v;
+				v += m_step;
+			}
+		}
+
+		/**
+		select roi (relative to current roi), nothing is generated
+		**/
+		inline s_range_gen roi(const Rect& ROI) const {
+			return s_range_gen(m_start, m_step, m_size, Rect(m_roi.x + ROI.x, m_roi.y + ROI.y, ROI.width, ROI.height));
+		}
+
+		/**
+		min / max without generating values (affine in the index: extremes are at the corners),
+		integer values which wrap around the range of T_res are scanned, an empty roi gives 0 / 0
+		**/
+		inline void minmax(double& res_min, double& res_max) const {
+			if (m_roi.width <= 0 || m_roi.height <= 0) {
+				res_min = 0.;
+				res_max = 0.;
+				return;
+			}
+			if (std::is_integral<T_res>::value) {
+				double idx_first = (double)((i64)m_roi.y * m_size.width + m_roi.x);
+				double idx_last = (double)((i64)(m_roi.y + m_roi.height - 1) * m_size.width + m_roi.x + m_roi.width - 1);
+				double v_first = (double)m_start + (double)m_step * idx_first, v_last = (double)m_start + (double)m_step * idx_last;
+				if (std::min(v_first, v_last) < (double)std::numeric_limits<T_res>::lowest() || std::max(v_first, v_last) > (double)std::numeric_limits<T_res>::max()) {
+					gen_minmax_scan(*this, res_min, res_max);
+					return;
+				}
+			}
+			double v_first = (double)(*this)(0, 0), v_last = (double)(*this)(m_roi.height - 1, m_roi.width - 1);
+			res_min = std::min(v_first, v_last);
+			res_max = std::max(v_first, v_last);
+		}
+
+		inline void materialize(Mat& res) const {
+			gen_materialize(*this, res);
+		}
+
+		inline Mat mat() const {
+			Mat res;
+			materialize(res);
+			return res;
+		}
+	};
+
+	/*
+	lazy coordinate of one axis: value at (y, x) is start + x (axis 0) or start + y (axis 1)
+	*/
+	template<typename T_Src>
+	class s_axis_gen {
+	public:
+		typedef T_Src t_val;
+		i32 m_start;
+		i32 m_axis;
+		Size m_size;
+
+		s_axis_gen(const i32& start, const i32& axis, const Size& size)
+			: m_start(start), m_axis(axis), m_size(size) {}
+
+		inline Size size() const {
+			return m_size;
+		}
+
+		inline T_Src operator()(const i32& y, const i32& x) const {
+			return (T_Src)(m_start + (m_axis == 0 ? x : y));
+		}
+
+		inline void row(const i32& y, T_Src* res) const {
+			if (m_axis == 0) {
+				for (i32 x = 0; x < m_size.width; ++x) {
+					res[x] = (T_Src)(m_start + x);
+				}
+			}
+			else {
+				register T_Src v = (T_Src)(m_start + y);
+				for (i32 x = 0; x < m_size.width; ++x) {
+					res[x] = v;
+				}
+			}
+		}
+
+		inline s_axis_gen roi(const Rect& ROI) const {
+			return s_axis_gen(m_start + (m_axis == 0 ? ROI.x : ROI.y), m_axis, ROI.size());
+		}
+
+		/**
+		min / max without generating values, integer values which wrap around the range of T_Src are scanned, an empty size gives 0 / 0
+		**/
+		inline void minmax(double& res_min, double& res_max) const {
+			if (m_size.width <= 0 || m_size.height <= 0) {
+				res_min = 0.;
+				res_max = 0.;
+				return;
+			}
+			res_min = (double)m_start;
+			res_max = (double)m_start + (m_axis == 0 ? m_size.width : m_size.height) - 1;
+			if (res_min < (double)std::numeric_limits<T_Src>::lowest() || res_max > (double)std::numeric_limits<T_Src>::max()) {
+				gen_minmax_scan(*this, res_min, res_max);
+			}
+		}
+
+		inline void materialize(Mat& res) const {
+			gen_materialize(*this, res);
+		}
+
+		inline Mat mat() const {
+			Mat res;
+			materialize(res);
+			return res;
+		}
+	};
+
+	/*
+	lazy meshgrid: X / Y are generated on demand (e.g. fused into vis_colorize)
+	*/
+	template<typename T_Src>
+	class s_meshgrid_gen {
+	public:
+		Range m_xs;
+		Range m_ys;
+
+		s_meshgrid_gen(const Range& xs, const Range& ys) : m_xs(xs), m_ys(ys) {}
+
+		inline Size size() const {
+			return Size(m_xs.end - m_xs.start, m_ys.end - m_ys.start);
+		}
+
+		inline s_axis_gen<T_Src> x() const {
+			return s_axis_gen<T_Src>(m_xs.start, 0, size());
+		}
+
+		inline s_axis_gen<T_Src> y() const {
+			return s_axis_gen<T_Src>(m_ys.start, 1, size());
+		}
+
+		inline s_meshgrid_gen roi(const Rect& ROI) const {
+			return s_meshgrid_gen(Range(m_xs.start + ROI.x, m_xs.start + ROI.x + ROI.width), Range(m_ys.start + ROI.y, m_ys.start + ROI.y + ROI.height));
+		}
+
+		inline void materialize(Mat& X, Mat& Y) const {
+			x().materialize(X);
+			y().materialize(Y);
+		}
+	};
+
+	/**
+	generate meshgrid
+	**/
+	template<typename T_Src>
+	inline void meshgrid(const Range& xs, const Range& ys, Mat& X, Mat& Y) {
+		s_meshgrid_gen<T_Src>(xs, ys).materialize(X, Y);
+	}
+
+	/**
+	generate range mat
+	**/
+	template<typename T_res>
+	inline void range(const T_res start, const T_res step, const Size& size, Mat& res)
+	{
+		s_range_gen<T_res>(start, step, size).materialize(res);
+	}
+
 	/**
 	generate range mat
 	**/
@@ -134,27 +363,7 @@ namespace emat {
 	template<typename T_res>
 	inline void range(const T_res start, const T_res step, const Size& size, const Rect& ROI, Mat& res)
 	{
-		create<T_res>(Size(ROI.width, ROI.height), res);
-		register u32 y_start = ROI.y;
-		register T_res x_start_mul_step = ROI.x * step,
-			x_end_mul_step = (ROI.x + ROI.width) * step,
-			step_mul_matwidth = size.width * step;
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(emat_omp_cnt)
-#endif
-		emat_omp{
-			register auto y_offset = emat_omp_offset(ROI.height), y_offset_next = emat_omp_offset_next(ROI.height);
-			register T_res y = 0, x = 0;
-			register T_res y_start_omp = (T_res)(y_start + y_offset) * step_mul_matwidth + start,
-				y_end_omp = (T_res)(y_start + y_offset_next) * step_mul_matwidth + start,
-				x_end_omp;
-			register auto p_res = (T_res*)res.data + y_offset * ROI.width;
-			for (y = y_start_omp; y < y_end_omp; y += step_mul_matwidth) {
-				for (x = y + x_start_mul_step, x_end_omp = y + x_end_mul_step; x < x_end_omp; ++x) {
-					*(p_res++) = x;
-				}
-			}
-		}
+		s_range_gen<T_res>(start, step, size, ROI).materialize(res);
 	}
 
 	/**
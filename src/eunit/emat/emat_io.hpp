@@ -0,0 +1,313 @@
+/*****************************************************************//**
+ *      @file  emat_io.h
+ *      @brief Provide loading of dumps (.npy / headered raw / cv::FileStorage), files are memory mapped
+ *
+ *  Detail Decsription starts here
+ *  [Example]:
+ *  s_mmap_file file;
+ *  Mat tensor;
+ *  if (load_dump("dump/feat.npy", file, tensor)) {		//no copy: pages are read when pixels are accessed
+ *  	viewer.img_show_cache_shared("feat", Size(640, 480), tensor, s_vis_policy(COLORMAP_JET, s_vis_range::percentile()), texts);
+ *  }
+ *  save_raw("dump/feat.raw", tensor);					//headered raw, loaded by load_raw / load_dump
+ *   @internal
+ *     Project
+ *     Created  10/19/2026
+ *    Revision  10/19/2026
+ *     Company
+ *   Copyright
+ *
+ * *******************************************************************/
+
+#ifndef EMAT_IO_H_
+#define EMAT_IO_H_
+
+#include "emat_core.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace emat {
+	/*
+	read-only memory mapped file, mats wrapping its data do not own it (keep the file open while they are used)
+	*/
+	class s_mmap_file {
+	private:
+		const u8* m_data = 0;
+		size_t m_size = 0;
+#ifdef _WIN32
+		HANDLE m_file = INVALID_HANDLE_VALUE;
+		HANDLE m_mapping = 0;
+#endif
+
+		s_mmap_file(const s_mmap_file&);
+		s_mmap_file& operator=(const s_mmap_file&);
+
+	public:
+		s_mmap_file() {}
+
+		~s_mmap_file() {
+			close();
+		}
+
+		/**
+		map a file (read only)
+		@param file_name [in] path of file
+		@return false if the file can not be mapped (e.g. missing or empty)
+		**/
+		inline bool open(const string& file_name) {
+			close();
+#ifdef _WIN32
+			m_file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+			if (m_file == INVALID_HANDLE_VALUE) return false;
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+				close();
+				return false;
+			}
+			m_mapping = CreateFileMappingA(m_file, 0, PAGE_READONLY, 0, 0, 0);
+			m_data = m_mapping ? (const u8*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+			m_size = (size_t)size.QuadPart;
+#else
+			int fd = ::open(file_name.c_str(), O_RDONLY);
+			if (fd < 0) return false;
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0) {
+				::close(fd);
+				return false;
+			}
+			void* p = mmap(0, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			::close(fd);		//the mapping stays valid
+			m_data = p == MAP_FAILED ? 0 : (const u8*)p;
+			m_size = (size_t)st.st_size;
+#endif
+			if (!m_data) {
+				close();
+				return false;
+			}
+			return true;
+		}
+
+		inline void close() {
+#ifdef _WIN32
+			if (m_data) UnmapViewOfFile(m_data);
+			if (m_mapping) CloseHandle(m_mapping);
+			if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+			m_mapping = 0;
+			m_file = INVALID_HANDLE_VALUE;
+#else
+			if (m_data) munmap((void*)m_data, m_size);
+#endif
+			m_data = 0;
+			m_size = 0;
+		}
+
+		inline const u8* data() const {
+			return m_data;
+		}
+
+		inline size_t size() const {
+			return m_size;
+		}
+	};
+
+	/**
+	wrap mapped bytes as a mat (no copy)
+	@param data [in] first element
+	@param shape [in] dims of tensor (last dim is taken as channels if channels > 1)
+	@param depth [in] cv depth of elements
+	@param channels [in] channels of elements
+	@param res [out] 2D mat (shape of 1 / 2 dims) or N-D mat
+	@return
+	**/
+	inline void wrap_tensor(const u8* data, const vector<int>& shape, const int& depth, const int& channels, Mat& res) {
+		int type = CV_MAKETYPE(depth, channels);
+		if (shape.size() == 0) {
+			res = Mat(1, 1, type, (void*)data);
+		}
+		else if (shape.size() == 1) {
+			res = Mat(1, shape[0], type, (void*)data);
+		}
+		else {
+			res = Mat((int)shape.size(), shape.data(), type, (void*)data);
+		}
+	}
+
+	/**
+	load a .npy file (C order, little endian (native byte order of x86 / arm), numeric dtypes of cv depths), a last dim of 2..4 of a 3D tensor is taken as channels (H x W x C)
+	@param file_name [in] path of file
+	@param file [out] mapping which holds the data of res
+	@param res [out] mat wrapping the mapped data
+	@return false if the file is not a supported .npy file
+	**/
+	inline bool load_npy(const string& file_name, s_mmap_file& file, Mat& res) {
+		if (!file.open(file_name) || file.size() < 10 || memcmp(file.data(), "\x93NUMPY", 6) != 0) return false;
+		const u8* p = file.data();
+		size_t header_len = p[6] == 1 ? (size_t)(p[8] | (p[9] << 8)) : (file.size() < 12 ? 0 : (size_t)(p[8] | (p[9] << 8) | (p[10] << 16) | ((size_t)p[11] << 24)));
+		size_t header_start = p[6] == 1 ? 10 : 12;
+		if (header_len == 0 || header_start + header_len > file.size()) return false;
+		string header((const char*)p + header_start, header_len);
+		//'descr': '<f4'
+		size_t pos = header.find("'descr'");
+		if (pos == string::npos || (pos = header.find('\'', pos + 7)) == string::npos) return false;
+		string descr = header.substr(pos + 1, header.find('\'', pos + 1) - pos - 1);
+		const char* descrs[] = { "u1", "i1", "u2", "i2", "i4", "f4", "f8", "b1" };
+		const int depths[] = { CV_8U, CV_8S, CV_16U, CV_16S, CV_32S, CV_32F, CV_64F, CV_8U };
+		int depth = -1;
+		for (int i = 0; i < (int)(sizeof(descrs) / sizeof(descrs[0])); ++i) {
+			if (descr.size() == 3 && descr.substr(1) == descrs[i] && descr[0] != '>') {
+				depth = depths[i];
+			}
+		}
+		if (depth < 0 || header.find("'fortran_order': True") != string::npos) return false;
+		//'shape': (1080, 1920, 3)
+		if ((pos = header.find("'shape'")) == string::npos || (pos = header.find('(', pos)) == string::npos) return false;
+		vector<int> shape;
+		for (const char* s = header.c_str() + pos + 1; *s && *s != ')'; ) {
+			char* end;
+			long v = strtol(s, &end, 10);
+			if (end == s) {
+				++s;
+				continue;
+			}
+			shape.emplace_back((int)v);
+			s = end;
+		}
+		size_t cnt = 1;
+		for (auto& v : shape) cnt *= (size_t)v;
+		size_t data_start = header_start + header_len;
+		if (data_start + cnt * CV_ELEM_SIZE(depth) > file.size() || cnt == 0) return false;
+		int channels = 1;
+		if (shape.size() == 3 && shape[2] >= 2 && shape[2] <= 4) {
+			channels = shape[2];
+			shape.pop_back();
+		}
+		wrap_tensor(file.data() + data_start, shape, depth, channels, res);
+		return true;
+	}
+
+	/*
+	headered raw: a text line "EMATRAW1 <depth> <channels> <d0> <d1> ...", padded by spaces to 64 bytes (data stays aligned), followed by the raw elements in C order
+	*/
+	static const char* const emat_raw_magic = "EMATRAW1";
+	static const size_t emat_raw_header_size = 64;
+
+	/**
+	save a continuous mat as headered raw (dumps of production code, see load_raw)
+	**/
+	inline bool save_raw(const string& file_name, const Mat& src) {
+		assert(src.isContinuous());
+		const char* depth_names[] = { "8U", "8S", "16U", "16S", "32S", "32F", "64F" };
+		string header = string(emat_raw_magic) + " " + depth_names[src.depth()] + " " + to_string(src.channels());
+		for (int i = 0; i < src.dims; ++i) {
+			header += " " + to_string(src.size[i]);
+		}
+		if (header.size() + 1 > emat_raw_header_size) return false;
+		header.resize(emat_raw_header_size - 1, ' ');
+		header += '\n';
+		FILE* f = fopen(file_name.c_str(), "wb");
+		if (!f) return false;
+		bool ok = fwrite(header.data(), 1, header.size(), f) == header.size() && fwrite(src.data, src.elemSize(), src.total(), f) == src.total();
+		fclose(f);
+		return ok;
+	}
+
+	/**
+	load a headered raw file (see save_raw)
+	@param file_name [in] path of file
+	@param file [out] mapping which holds the data of res
+	@param res [out] mat wrapping the mapped data
+	@return false if the file is not a headered raw file
+	**/
+	inline bool load_raw(const string& file_name, s_mmap_file& file, Mat& res) {
+		if (!file.open(file_name) || file.size() < emat_raw_header_size || memcmp(file.data(), emat_raw_magic, strlen(emat_raw_magic)) != 0) return false;
+		string header((const char*)file.data(), emat_raw_header_size);
+		const char* depth_names[] = { "8U", "8S", "16U", "16S", "32S", "32F", "64F" };
+		char depth_name[8] = { 0 };
+		int channels = 0, offset = 0;
+		if (sscanf(header.c_str() + strlen(emat_raw_magic), "%7s %d%n", depth_name, &channels, &offset) < 2 || channels < 1 || channels > CV_CN_MAX) return false;
+		int depth = -1;
+		for (int i = 0; i < (int)(sizeof(depth_names) / sizeof(depth_names[0])); ++i) {
+			if (strcmp(depth_name, depth_names[i]) == 0) depth = i;
+		}
+		if (depth < 0) return false;
+		vector<int> shape;
+		const char* s = header.c_str() + strlen(emat_raw_magic) + offset;
+		for (char* end; ; s = end) {
+			long v = strtol(s, &end, 10);
+			if (end == s) break;
+			shape.emplace_back((int)v);
+		}
+		size_t cnt = 1;
+		for (auto& v : shape) cnt *= (size_t)v;
+		if (cnt == 0 || emat_raw_header_size + cnt * CV_ELEM_SIZE(CV_MAKETYPE(depth, channels)) > file.size()) return false;
+		wrap_tensor(file.data() + emat_raw_header_size, shape, depth, channels, res);
+		return true;
+	}
+
+	/**
+	load the first mat of a cv::FileStorage file (.yml / .yaml / .xml / .json)
+	(elements are stored as text / base64, so they are parsed into heap memory, no mapping)
+	**/
+	inline bool load_fs(const string& file_name, Mat& res) {
+		FileStorage fs(file_name, FileStorage::READ);
+		if (!fs.isOpened()) return false;
+		for (auto it = fs.root().begin(); it != fs.root().end(); ++it) {
+			(*it) >> res;
+			if (!res.empty()) return true;
+		}
+		return false;
+	}
+
+	/**
+	load a dump by its extension (.npy / .raw are mapped, others are read by cv::FileStorage)
+	@param file_name [in] path of file
+	@param file [out] mapping which holds the data of res (closed for FileStorage files)
+	@param res [out] mat
+	@return
+	**/
+	inline bool load_dump(const string& file_name, s_mmap_file& file, Mat& res) {
+		res.release();
+		file.close();
+		string ext = file_name.substr(min(file_name.rfind('.'), file_name.size()));
+		transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+		if (ext == ".npy") return load_npy(file_name, file, res);
+		if (ext == ".raw") return load_raw(file_name, file, res);
+		return load_fs(file_name, res);
+	}
+
+	/**
+	list dumps of a directory (sorted by name)
+	**/
+	inline void list_dumps(const string& dir, vector<string>& res) {
+		vector<String> files;
+		glob(dir, files, false);
+		res.clear();
+		const char* exts[] = { ".npy", ".raw", ".yml", ".yaml", ".xml", ".json", ".gz" };
+		for (auto& file : files) {
+			string name = file;
+			string ext = name.substr(min(name.rfind('.'), name.size()));
+			transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+			for (auto e : exts) {
+				if (ext == e) {
+					res.emplace_back(name);
+					break;
+				}
+			}
+		}
+		sort(res.begin(), res.end());
+	}
+}
+#endif
@@ -32,6 +32,23 @@
  *  		(*p_res++) = (T_res)((*p_src1++) + (*p_src2++));
  *  	}
  *  }
+ *  (emat_omp_offset_mat requires continuous mats)
+
+ *  [Example]: (stride aware, for roi views / non-continuous mats)
+ *  Mat mt;
+ *  create<T_res>(size(src1_mat), mt);
+ *  register auto x_len = src1_mat.cols * src1_mat.channels();
+ *  #pragma omp parallel for num_threads(emat_omp_cnt)
+ *  emat_omp{
+ *  	for (int y = emat_omp_offset_rows(mt), y_end = emat_omp_offset_next_rows(mt); y < y_end; ++y) {
+ *  		register auto p_src1 = src1_mat.ptr<T_Src1>(y);
+ *  		register auto p_src2 = src2_mat.ptr<T_Src2>(y);
+ *  		register auto p_res = mt.ptr<T_res>(y);
+ *  		for (int x = 0; x < x_len; ++x) {
+ *  			p_res[x] = (T_res)(p_src1[x] + p_src2[x]);
+ *  		}
+ *  	}
+ *  }
  *   @internal
  *     Project
  *     Created  1/7/2019
@@ -58,6 +75,8 @@
 #define emat_omp_offset_next_range(start, end) ((start) + emat_omp_offset_next(((end) - (start))))
 #define emat_omp_offset_mat(T, M) ((T*)(M).data + emat_omp_offset((u32)(M).total()))
 #define emat_omp_offset_next_mat(T, M) ((T*)(M).data + emat_omp_offset_next((u32)(M).total()))
+#define emat_omp_offset_rows(M) ((i32)emat_omp_offset((u32)(M).rows))
+#define emat_omp_offset_next_rows(M) ((i32)emat_omp_offset_next((u32)(M).rows))
 
 
 #endif
\ No newline at end of file
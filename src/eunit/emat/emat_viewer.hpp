@@ -20,9 +20,17 @@
 #include <unordered_map>
 #include "emat_core.hpp"
 #include "emat_omp.hpp"
+#include "emat_format.hpp"
+#include "emat_arena.hpp"
+#include "emat_visual.hpp"
+#include "emat_watch.hpp"
 #include <string.h>
 #include <set>
+#include <algorithm>
 #include <mutex>
+#include <chrono>
+#include <future>
+#include <cfloat>
 #include "emat_omp.hpp"
 
 using namespace std;
@@ -46,6 +54,32 @@ namespace emat {
 
 	};
 
+	/**
+	min / max of values, huge mats (e.g. memory mapped dumps) are estimated by a subset of rows,
+	so that only the pages of rows sampled are read
+	@param src [in] mat of any depth / channels
+	@param val_min [out] min of values
+	@param val_max [out] max of values
+	@return
+	**/
+	inline void minmax_sampled(const Mat& src, double& val_min, double& val_max) {
+		const size_t scan_max = (size_t)1 << 24;
+		Mat src_reshape = src.reshape(1);
+		if (src_reshape.total() <= scan_max) {
+			minMaxLoc(src_reshape, &val_min, &val_max);
+			return;
+		}
+		int step = (int)((src_reshape.total() + scan_max - 1) / scan_max);
+		val_min = DBL_MAX;
+		val_max = -DBL_MAX;
+		for (int y = 0; y < src_reshape.rows; y += step) {
+			double v_min, v_max;
+			minMaxLoc(src_reshape.row(y), &v_min, &v_max);
+			val_min = min(val_min, v_min);
+			val_max = max(val_max, v_max);
+		}
+	}
+
 	/*
 	provide a watch window for visualizing mat
 	*/
@@ -55,43 +89,107 @@ namespace emat {
 		{
 		private:
 			const int m_mul_txts_pad = 4;
-			unique_ptr<vector<string>[]> raw_vals_txts;
+			enum { m_txt_tile_size = 32 };
+			vector<unique_ptr<s_val_txts[]>> m_txt_tiles;		//texts of values, allocated per tile on first access
+			int m_txt_tiles_cols = 0;
+
+			/*
+			format kernel (see depth_dispatch), selected once per frame
+			*/
+			template<typename T_Src>
+			struct s_fmt_kernel {
+				static inline void run(const Mat& raw, const int& loc_x, const int& loc_y, const int& precision, s_val_txts& res) {
+					auto c = min(raw.channels(), (int)s_val_txts::capacity);
+					auto p = raw.ptr<T_Src>(loc_y) + loc_x * raw.channels();
+					for (int i = 0; i < c; ++i) {
+						fmt_val(p[i], precision, res.txts[i]);
+					}
+					res.cnt = (u8)c;
+				}
+			};
+			typedef decltype(&s_fmt_kernel<u8>::run) t_fmt_fn;
+			t_fmt_fn m_fmt_fn;
+
+			/*
+			format kernel of native formats: Y / U / V of NV12, CFA channel + value of Bayer
+			*/
+			template<int Format, typename T_Src>
+			struct s_fmt_native_kernel {
+				static inline void run(const Mat& raw, const int& loc_x, const int& loc_y, const int& /*precision*/, s_val_txts& res) {
+					if (Format == vis_format_nv12) {
+						auto p_uv = raw.data + (size_t)(raw.rows + loc_y / 2) * raw.step[0] + (loc_x & ~1);	//UV plane follows the Y plane
+						fmt_int_labeled('Y', raw.ptr<u8>(loc_y)[loc_x], res.txts[0]);
+						fmt_int_labeled('U', p_uv[0], res.txts[1]);
+						fmt_int_labeled('V', p_uv[1], res.txts[2]);
+						res.cnt = 3;
+					}
+					else {
+						fmt_int_labeled("BGR"[vis_bayer_channel(Format, loc_x, loc_y)], raw.ptr<T_Src>(loc_y)[loc_x], res.txts[0]);
+						res.cnt = 1;
+					}
+				}
+			};
+
+			static inline t_fmt_fn native_fmt_fn(const int& format, const int& depth) {
+				static const t_fmt_fn fns[][2] = {
+					{ &s_fmt_native_kernel<vis_format_nv12, u8>::run, &s_fmt_native_kernel<vis_format_nv12, u8>::run },
+					{ &s_fmt_native_kernel<vis_format_bayer_rggb, u8>::run, &s_fmt_native_kernel<vis_format_bayer_rggb, u16>::run },
+					{ &s_fmt_native_kernel<vis_format_bayer_bggr, u8>::run, &s_fmt_native_kernel<vis_format_bayer_bggr, u16>::run },
+					{ &s_fmt_native_kernel<vis_format_bayer_grbg, u8>::run, &s_fmt_native_kernel<vis_format_bayer_grbg, u16>::run },
+					{ &s_fmt_native_kernel<vis_format_bayer_gbrg, u8>::run, &s_fmt_native_kernel<vis_format_bayer_gbrg, u16>::run },
+				};
+				return fns[format - vis_format_nv12][depth == CV_16U];
+			}
+
+			/*
+			clear cached texts of values
+			*/
+			inline void reset_txts() {
+				m_txt_tiles_cols = (m_raw.cols + m_txt_tile_size - 1) / m_txt_tile_size;
+				m_txt_tiles.clear();
+				m_txt_tiles.resize(m_txt_tiles_cols * ((m_raw.rows + m_txt_tile_size - 1) / m_txt_tile_size));
+			}
+
+			/*
+			allocate text tiles covering [x_start, x_end) x [y_start, y_end) (call before formatting in parallel)
+			*/
+			inline void prepare_txts(const int& x_start, const int& x_end, const int& y_start, const int& y_end) {
+				for (int ty = y_start / m_txt_tile_size, ty_end = (y_end + m_txt_tile_size - 1) / m_txt_tile_size; ty < ty_end; ++ty) {
+					for (int tx = x_start / m_txt_tile_size, tx_end = (x_end + m_txt_tile_size - 1) / m_txt_tile_size; tx < tx_end; ++tx) {
+						auto& tile = m_txt_tiles[ty * m_txt_tiles_cols + tx];
+						if (!tile) {
+							tile = unique_ptr<s_val_txts[]>(new s_val_txts[m_txt_tile_size * m_txt_tile_size]);
+						}
+					}
+				}
+			}
+
 			/**
 			Convert value of a point in Mat to string
-			@param src [in] array with Mat type
 			@param loc_x [in] location x
 			@param loc_y [in] localtion y
 			@param res [out] strings
 			@return
 			**/
-			inline void raw_val_to_txt(const int& offset, vector<string>*& res) {
-				res = &raw_vals_txts[offset];
-				if (res->size() == 0) {
-#define format_mat(t) { auto c = m_raw.channels(); auto p = (t*)m_raw.data + offset * c; for(int i = 0; i < c; ++i) {res->emplace_back(to_string(p[i]));}}
-					if (m_raw.type() == CV_8UC1 || m_raw.type() == CV_8UC2 || m_raw.type() == CV_8UC3 || m_raw.type() == CV_8UC4) format_mat(u8)
-					else if (m_raw.type() == CV_8SC1 || m_raw.type() == CV_8SC2 || m_raw.type() == CV_8SC3 || m_raw.type() == CV_8SC4) format_mat(i8)
-					else if (m_raw.type() == CV_16UC1 || m_raw.type() == CV_16UC2 || m_raw.type() == CV_16UC3 || m_raw.type() == CV_16UC4) format_mat(u16)
-					else if (m_raw.type() == CV_16SC1 || m_raw.type() == CV_16SC2 || m_raw.type() == CV_16SC3 || m_raw.type() == CV_16SC4) format_mat(i16)
-					else if (m_raw.type() == CV_32SC1 || m_raw.type() == CV_32SC2 || m_raw.type() == CV_32SC3 || m_raw.type() == CV_32SC4) format_mat(i32)
-					else if (m_raw.type() == CV_32FC1 || m_raw.type() == CV_32FC2 || m_raw.type() == CV_32FC3 || m_raw.type() == CV_32FC4) format_mat(float)
-					else if (m_raw.type() == CV_64FC1 || m_raw.type() == CV_64FC2 || m_raw.type() == CV_64FC3 || m_raw.type() == CV_64FC4) format_mat(double)
-#undef format_mat
+			inline void raw_val_to_txt(const int& loc_x, const int& loc_y, s_val_txts*& res) {
+				auto& tile = m_txt_tiles[(loc_y / m_txt_tile_size) * m_txt_tiles_cols + loc_x / m_txt_tile_size];
+				if (!tile) {
+					prepare_txts(loc_x, loc_x + 1, loc_y, loc_y + 1);
+				}
+				res = &tile[(loc_y % m_txt_tile_size) * m_txt_tile_size + loc_x % m_txt_tile_size];
+				if (res->cnt == 0) {
+					m_fmt_fn(m_raw, loc_x, loc_y, m_val_precision, *res);
 				}
-			}
-
-			inline void raw_val_to_txt(const int& loc_x, const int& loc_y, vector<string>*& res) {
-				raw_val_to_txt(loc_y * m_raw.cols + loc_x, res);
 			}
 
 			/**
 			Convert value of a point in Mat to string
-			@param src [in] array with Mat type
 			@param loc [in] location
 			@param res [out] strings
 			@return
 			**/
-			inline void raw_val_to_txt(const Point2i& loc, vector<string>*& res) {
-				raw_val_to_txt(loc.y * m_raw.cols + loc.x, res);
+			inline void raw_val_to_txt(const Point2i& loc, s_val_txts*& res) {
+				raw_val_to_txt(loc.x, loc.y, res);
 			}
 
 			/**
@@ -104,7 +202,11 @@ namespace emat {
 
 			}
 
-			inline void get_txts_size(const vector<string>& txts, const int& font_face, const double& font_scale, const int& font_thickness, Size& res) {
+			inline void get_txt_size(const s_val_txt& txt, const int& font_face, const double& font_scale, const int& font_thickness, Size& res) {
+				get_txt_size(txt.str(), font_face, font_scale, font_thickness, res);
+			}
+
+			inline void get_txts_size(const s_val_txts& txts, const int& font_face, const double& font_scale, const int& font_thickness, Size& res) {
 				int cnt = (int)txts.size();
 				if (cnt == 1) {
 					get_txt_size(txts[0], font_face, font_scale, font_thickness, res);
@@ -112,7 +214,7 @@ namespace emat {
 				else if(cnt > 1){
 					int idx = 0;
 					for (int i = 1; i < cnt; ++i) {
-						if (txts[i].size() > txts[idx].size()) {
+						if (txts[i].len > txts[idx].len) {
 							idx = i;
 						}
 					}
@@ -131,26 +233,28 @@ namespace emat {
 				cv::putText(res, txt, Point(loc.x, loc.y - 2), font_face, font_scale, font_color, font_thickness);
 			}
 
+			inline void put_txt(const s_val_txt& txt, const Point& loc, const int& font_face, const double& font_scale, const Scalar& font_color, const int& font_thickness, Mat& res) {
+				put_txt(txt.str(), loc, font_face, font_scale, font_color, font_thickness, res);
+			}
+
 			/**
 			draw multipy texts on Mat
 			**/
-			inline void put_txts(const vector<string>& txts, const Point& loc, const int& font_face, const double& font_scale, const Scalar& font_color, const int& font_thickness, Mat& res) {
+			inline void put_txts(const s_val_txts& txts, const Point& loc, const int& font_face, const double& font_scale, const Scalar& font_color, const int& font_thickness, Mat& res) {
 				int cnt = (int)txts.size();
 				if (cnt == 1) {
 					put_txt(txts[0], loc, font_face, font_scale, font_color, font_thickness, res);
 				}
 				else if (cnt > 1) {
-					Size txts_size[4];
+					Size txts_size[s_val_txts::capacity];
 					Size txts_max_size;
-					int txt_idx = 0;
-					for (auto& txt : txts) {
-						get_txt_size(txt, font_face, font_scale, font_thickness, txts_size[txt_idx]);
+					for (int txt_idx = 0; txt_idx < cnt; ++txt_idx) {
+						get_txt_size(txts[txt_idx], font_face, font_scale, font_thickness, txts_size[txt_idx]);
 						txts_max_size.width = max(txts_max_size.width, txts_size[txt_idx].width);
 						txts_max_size.height += txts_size[txt_idx].height;
-						++txt_idx;
 					}
 					txts_max_size.height += (cnt - 1) * m_mul_txts_pad;
-					for (int i = (int)txts.size() - 1, y_offset = 0; i >= 0; --i) {
+					for (int i = cnt - 1, y_offset = 0; i >= 0; --i) {
 						put_txt(txts[i], Point(loc.x + (txts_max_size.width - txts_size[i].width) / 2, loc.y + y_offset), font_face, font_scale, font_color, font_thickness, res);
 						y_offset -= txts_size[i].height + m_mul_txts_pad;
 					}
@@ -215,280 +319,1090 @@ namespace emat {
 					res_roi.height = src.rows - res_roi.y;
 				}
 			}
-			Mat m_colored_vis;
-		public:
-			string m_win_name;
-			Mat m_colored;
-			Mat m_colored_vis_tiptool;
-			vector<s_viewer_text> m_colored_txts;
-			Mat m_raw;
-			Point2f m_center;
-			float m_scale_factor;
-			u64 m_idx;
-			Size m_win_size;
-			Size m_org_size;
-			float m_val_font_scale = 0.34f;
-			int m_val_font_thickness = 1;
-			int m_val_font_face = (int)FONT_HERSHEY_SIMPLEX;
-			Scalar m_tiptool_font_color = Scalar::all(255);
-			int m_tiptool_font_face = (int)FONT_HERSHEY_SIMPLEX;
-			float m_tiptool_font_scale = 0.5f;
-			int m_tiptool_font_thickness = 2;
-			Scalar m_grid_color = Scalar::all(200);
-			int m_grid_thickness = 1;
-			Point2f m_tiptool_loc = Point2f(-1.f, -1.f);
-			bool m_grid_view_mode = false;
-			Size m_val_font_max_size;
-			int m_box_margin = 10;
-			int m_box_size = 200;
-			Scalar m_box_color = Scalar::all(255);
-			int m_box_thickness = 2;
-			bool m_box_en = false;
-			void* m_tag;
-
-			s_cache_display(const string& win_name, const Size& win_size, const Mat& colored, const Mat& raw, const Point2f& center, const float& scale_factor, const  u64& idx, const vector<s_viewer_text>& txts, const Point2f& tiptool_loc, const bool& box_en)
-			{
-				assert(colored.size() == raw.size());
-				m_org_size = colored.size();
-				m_win_size = win_size;
+			/*
+			resampling map of one axis: m_idx[i] = floor(origin + step * i) (index of source pixel of window pixel i),
+			kept across set_roi calls, a pure translation by whole window pixels shifts the map
+			*/
+			class s_coord_map {
+			public:
+				vector<int> m_idx;
+				float m_origin = 0.f;
+				float m_step = 0.f;
+				int m_src_len = -1;
+				int m_start = 0;						//[m_start, m_end): window pixels inside source
+				int m_end = 0;
 
-				colored.copyTo(m_colored);
-				raw.copyTo(m_raw);
+				/**
+				update map
+				@param origin [in] source coordinate of window pixel 0
+				@param step [in] source pixels per window pixel
+				@param len [in] count of window pixels
+				@param src_len [in] count of source pixels
+				@return false if cached map is reused as it is
+				**/
+				inline bool update(const float& origin, const float& step, const int& len, const int& src_len) {
+					int n = (int)m_idx.size();
+					if (n == len && step == m_step && src_len == m_src_len) {
+						if (origin == m_origin) {
+							return false;
+						}
+						float k_f = (origin - m_origin) / step;
+						int k = (int)round(k_f);
+						if (k == 0 && fabs(k_f) < 1e-3f) {
+							return false;
+						}
+						if (abs(k) < n && fabs(k_f - k) < 1e-3f) {
+							//shift by k window pixels, only the uncovered entries are computed
+							//(origin is advanced by whole steps, so the error does not accumulate)
+							m_origin += step * k;
+							if (k > 0) {
+								memmove(m_idx.data(), m_idx.data() + k, (n - k) * sizeof(int));
+								fill(n - k, n);
+							}
+							else {
+								memmove(m_idx.data() - k, m_idx.data(), (n + k) * sizeof(int));
+								fill(0, -k);
+							}
+							update_range();
+							return true;
+						}
+					}
+					m_idx.resize(len);
+					m_origin = origin;
+					m_step = step;
+					m_src_len = src_len;
+					fill(0, len);
+					update_range();
+					return true;
+				}
 
-				m_win_name = win_name;
-				m_idx = idx;
-				m_colored_txts = txts;
-				m_box_en = box_en;
-				raw_vals_txts = unique_ptr<vector<string>[]>(new vector<string>[m_raw.total()]);
-				{
-					//Calculate the max text size of values in Mat
-					vector<string> val_txts;
-					Size min_val_font_size, max_val_font_size;
-					Mat m_raw_reshape = m_raw.reshape(1, 1);
-					double min_val, max_val;
-					minMaxLoc(m_raw_reshape, &min_val, &max_val);
-					vector<string> min_val_txts, max_val_txts;
-					bool is_f = (m_raw.type() == CV_32FC1 || m_raw.type() == CV_32FC2 || m_raw.type() == CV_32FC3 || m_raw.type() == CV_32FC4 ||
-						m_raw.type() == CV_64FC1 || m_raw.type() == CV_64FC2 || m_raw.type() == CV_64FC3 || m_raw.type() == CV_64FC4);
-					min_val_txts.emplace_back(is_f ? to_string(min_val) : to_string((int)min_val));
-					max_val_txts.emplace_back(is_f ? to_string(max_val) : to_string((int)max_val));
-					for (int i = 1, len = m_raw.channels(); i < len; ++i)
-					{
-						min_val_txts.emplace_back(min_val_txts.back());
-						max_val_txts.emplace_back(max_val_txts.back());
+				inline void fill(const int& i0, const int& i1) {
+					for (int i = i0; i < i1; ++i) {
+						m_idx[i] = (int)floor(m_origin + m_step * i);
 					}
-					get_txts_size(min_val_txts, m_val_font_face, m_val_font_scale, m_val_font_thickness, min_val_font_size);
-					get_txts_size(max_val_txts, m_val_font_face, m_val_font_scale, m_val_font_thickness, max_val_font_size);
-					m_val_font_max_size.width = max(min_val_font_size.width, max_val_font_size.width) + 4;
-					m_val_font_max_size.height = max(min_val_font_size.height, max_val_font_size.height) + 4;
 				}
-				m_tiptool_loc = tiptool_loc;
-				set_roi(center, scale_factor);
-			}
 
-			~s_cache_display() {
-			}
+				inline void update_range() {
+					//map is monotonic
+					m_start = (int)(lower_bound(m_idx.begin(), m_idx.end(), 0) - m_idx.begin());
+					m_end = (int)(lower_bound(m_idx.begin(), m_idx.end(), m_src_len) - m_idx.begin());
+				}
+			};
+		public:
+			/*
+			resampling maps of a view, shared by linked windows of same size (see viewer::link_views)
+			*/
+			class s_view_maps {
+			public:
+				s_coord_map m_xos;
+				s_coord_map m_yos;
+			};
+			shared_ptr<s_view_maps> m_maps = make_shared<s_view_maps>();
+		private:
+			bool m_shared = false;							//m_colored / m_raw reference frames of caller (no copy)
+			bool m_raw_mode = false;						//raw-only ingest: pixels are colorized on demand by m_policy
+			s_vis_policy m_policy;
+			enum { m_color_tile_size = 64 };
+			vector<Mat> m_color_tiles;						//colorized tiles of raw (raw-only ingest, zoomed in)
+			vector<u8> m_color_tiles_ready;
+			int m_color_tiles_cols = 0;
 
-			/**
-			set color of font
-			**/
-			inline void set_tiptool_color(const Scalar& font_color) {
-				m_tiptool_font_color = font_color;
-			}
+			/*
+			prefetched state of a slice of a stack (see set_slice)
+			*/
+			class s_slice_prefetch {
+			public:
+				int idx = -1;
+				double val_min = 0.;					//min / max of values (size of texts)
+				double val_max = 0.;
+				double frame_min = 0.;					//range statistics (see s_vis_policy::frame_range)
+				double frame_max = 0.;
+				Mat base;								//colorized sampled pixels of view (zoomed out only)
+				Vec<double, 6> base_key;				//maps / range of base
+			};
+			Mat m_stack;									//N-D source of slices (keeps data alive)
+			vector<Mat> m_slices;							//zero-copy 2D views, navigated by ctrl + wheel
+			int m_slice_idx = 0;
+			vector<s_viewer_text> m_stack_txts;				//texts of caller (slice label is appended)
+			future<s_slice_prefetch> m_prefetch[2];			//next / previous slice
+			int m_prefetch_idx[2] = { -1, -1 };
+			Mat m_slice_base;								//colorized view of current slice (from prefetch)
+			Vec<double, 6> m_slice_base_key;
 
 			/**
-			get location of Mat corrospond to the locaition of mouse
+			gather statistics of a slice and colorize its view (runs on background task, all inputs are copies)
 			**/
-			template<typename T_Src, typename T_Res>
-			inline void loc_from_mouse(const Point2f& center, const float& scale_factor, const T_Src& src_x, const T_Src& src_y, T_Res& res_x, T_Res& res_y) {
-				float roi_w, roi_h, roi_x, roi_y, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h;
-				cal_roi(center, scale_factor, roi_x, roi_y, roi_w, roi_h, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h);
-				res_x = (T_Res)(roi_x + src_x * roi_w_div_win_w);
-				res_y = (T_Res)(roi_y + src_y * roi_h_div_win_h);
+			static inline s_slice_prefetch prefetch_slice(const Mat slice, const int idx, const s_vis_policy policy, const s_coord_map xs, const s_coord_map ys, const Size win_size, const bool render_base) {
+				s_slice_prefetch res;
+				res.idx = idx;
+				minmax_sampled(slice, res.val_min, res.val_max);
+				policy.frame_range(slice, res.frame_min, res.frame_max);
+				if (render_base) {
+					s_vis_policy policy_next = policy;
+					policy_next.m_range.update(res.frame_min, res.frame_max);
+					res.base = Mat::zeros(win_size, CV_8UC3);
+					vis_colorize_sampled(slice, policy_next, xs.m_idx.data(), xs.m_start, xs.m_end, ys.m_idx.data(), ys.m_start, ys.m_end, res.base);
+					res.base_key = Vec<double, 6>(xs.m_origin, xs.m_step, ys.m_origin, ys.m_step, policy_next.m_range.m_min, policy_next.m_range.m_max);
+				}
+				return res;
 			}
 
 			/**
-			get location of Mat corrospond to the locaition of mouse
+			start prefetching neighbors of current slice (skipped while a previous prefetch is still running)
 			**/
-			template<typename T_Src, typename T_Res>
-			inline void loc_from_mouse(const T_Src& src_x, const T_Src& src_y, T_Res& res_x, T_Res& res_y) {
-				loc_from_mouse<T_Src, T_Res>(m_center, m_scale_factor, src_x, src_y, res_x, res_y);
+			inline void launch_prefetch() {
+				//base is only useful when zoomed out (sampled colorization, see set_roi)
+				bool render_base = m_raw_mode && (int)m_maps->m_xos.m_idx.size() == m_win_size.width && (int)m_maps->m_yos.m_idx.size() == m_win_size.height && m_maps->m_xos.m_step * m_maps->m_yos.m_step > 1.f;
+				int nexts[2] = { m_slice_idx + 1, m_slice_idx - 1 };
+				for (int k = 0; k < 2; ++k) {
+					if (nexts[k] < 0 || nexts[k] >= (int)m_slices.size() || nexts[k] == m_prefetch_idx[k]) continue;
+					if (m_prefetch[k].valid() && m_prefetch[k].wait_for(chrono::seconds(0)) != future_status::ready) continue;
+					m_prefetch_idx[k] = nexts[k];
+					m_prefetch[k] = async(launch::async, &s_cache_display::prefetch_slice, m_slices[nexts[k]], nexts[k], m_policy, m_maps->m_xos, m_maps->m_yos, m_win_size, render_base);
+				}
 			}
 
 			/**
-			get location of Mat corrospond to the locaition of mouse
+			wait for prefetching and release stack
 			**/
-			template<typename T_Src, typename T_Res>
-			inline void loc_from_mouse(const Point2f& center, const float& scale_factor, const Point_<T_Src>& src, Point_<T_Res>& res) {
-				loc_from_mouse<T_Src, T_Res>(center, scale_factor, src.x, src.y, res.x, res.y);
+			inline void clear_stack() {
+				for (int k = 0; k < 2; ++k) {
+					if (m_prefetch[k].valid()) {
+						m_prefetch[k].wait();
+						m_prefetch[k] = future<s_slice_prefetch>();
+					}
+					m_prefetch_idx[k] = -1;
+				}
+				m_slices.clear();
+				m_stack.release();
+				m_slice_base.release();
 			}
 
 			/**
-			get location of Mat corrospond to the locaition of mouse
+			texts of caller + label of slice
 			**/
-			template<typename T_Src, typename T_Res>
-			inline void loc_from_mouse(const Point_<T_Src>& src, Point_<T_Res>& res) {
-				loc_from_mouse<T_Src, T_Res>(m_center, m_scale_factor, src.x, src.y, res.x, res.y);
+			inline vector<s_viewer_text> stack_txts(const int& idx, const int& cnt) const {
+				vector<s_viewer_text> res = m_stack_txts;
+				s_viewer_text label;
+				label.text = "slice " + to_string(idx) + " / " + to_string(cnt);
+				label.font_scale = 0.8f;
+				label.font_thickness = 1;
+				label.loc = Point2i(4, -6);
+				label.font_offset = Point2f(0.f, 0.f);
+				label.win_offset = Point2f(0.f, 1.f);
+				res.emplace_back(label);
+				return res;
 			}
 
+			/*
+			subtitle rasterized for the current texts / window size (see build_txt_overlays)
+			*/
+			class s_txt_overlay {
+			public:
+				Rect rect;										//bounding rect in window
+				Mat mask;										//CV_8UC3, 255 where covered by glyphs
+				Mat color;										//CV_8UC3, color of text where covered, 0 elsewhere
+			};
+			vector<s_txt_overlay> m_txt_overlays;
+			Size m_txt_overlays_size;						//window size of overlays (empty: texts changed)
+
+			/*
+			cells of grid mode whose texts are not rendered yet (rendered in slices within a frame budget, see render_grid_txts)
+			*/
+			class s_grid_txts {
+			public:
+				int x_start = 0;
+				int x_end = 0;
+				int y_next = 0;									//rows of cells left: [y_next, y_end)
+				int y_end = 0;
+			};
+			s_grid_txts m_grid_txts;
+
+			enum { m_damage_tile_size = m_txt_tile_size };	//tiles of change masks (a tile of texts, a quarter of a color tile)
+			vector<u8> m_damage;							//changed tiles of new frame (see diff_frame), empty: not compared (full render)
+			int m_damage_cols = 0;
+
 			/**
-			get location of mouse corrospond to the locaition of Mat
+			compare two frames tile by tile, rows of a tile are compared by memcmp (vectorized) until the first difference
+			@param prev [in] previous frame
+			@param cur [in] new frame (same size / type)
+			@param tile_size [in] size of tiles in prev / cur
+			@param res [in,out] flags of tiles (row major), changed tiles are set, others are kept
+			@param res_cols [in] tiles per row of res
+			@return
 			**/
-			template<typename T_Src, typename T_Res>
-			inline void loc_to_mouse(const Point2f& center, const float& scale_factor, const T_Src& src_x, const T_Src& src_y, T_Res& res_x, T_Res& res_y) {
-				float roi_w, roi_h, roi_x, roi_y, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h;
-				cal_roi(center, scale_factor, roi_x, roi_y, roi_w, roi_h, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h);
-				res_x = (T_Res)((src_x - roi_x) * win_w_div_roi_w);
-				res_y = (T_Res)((src_y - roi_y) * win_h_div_roi_h);
+			static inline void diff_tiles(const Mat& prev, const Mat& cur, const Size& tile_size, vector<u8>& res, const int& res_cols) {
+				register size_t elem_size = cur.elemSize();
+				int tiles_rows = (cur.rows + tile_size.height - 1) / tile_size.height;
+				assert((cur.cols + tile_size.width - 1) / tile_size.width == res_cols && tiles_rows * res_cols <= (int)res.size());
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt) schedule(dynamic)
+#endif
+				for (int ty = 0; ty < tiles_rows; ++ty) {
+					u8* p_res = res.data() + ty * res_cols;
+					for (int y = ty * tile_size.height, y_end = min(y + tile_size.height, cur.rows); y < y_end; ++y) {
+						const u8* p_prev = prev.ptr<u8>(y), * p_cur = cur.ptr<u8>(y);
+						for (int tx = 0; tx < res_cols; ++tx) {
+							if (p_res[tx]) continue;
+							size_t offset = tx * tile_size.width * elem_size, len = min(tile_size.width, cur.cols - tx * tile_size.width) * elem_size;
+							p_res[tx] = memcmp(p_prev + offset, p_cur + offset, len) != 0;
+						}
+					}
+				}
 			}
 
 			/**
-			get location of mouse corrospond to the locaition of Mat
+			compare a new frame with the current one before it is overwritten, changed tiles are accumulated into m_damage
+			@param prev [in] current frame / plane
+			@param cur [in] new frame / plane
+			@param first [in] first plane of frame (m_damage is reset)
+			@param tile_rows [in] rows of a tile in prev / cur (e.g. half of a tile for UV plane of NV12)
+			@return
 			**/
-			template<typename T_Src, typename T_Res>
-			inline void loc_to_mouse(const T_Src& src_x, const T_Src& src_y, T_Res& res_x, T_Res& res_y) {
-				loc_to_mouse<T_Src, T_Res>(m_center, m_scale_factor, src_x, src_y, res_x, res_y);
+			inline void diff_frame(const Mat& prev, const Mat& cur, const bool& first, const int& tile_rows = m_damage_tile_size) {
+				if (first) {
+					m_damage_cols = (cur.cols + m_damage_tile_size - 1) / m_damage_tile_size;
+					m_damage.assign(m_damage_cols * ((cur.rows + tile_rows - 1) / tile_rows), 0);
+				}
+				else if (m_damage.empty()) {
+					return;
+				}
+				if (!m_damage_tracking || prev.empty() || prev.dims != 2 || cur.dims != 2 || prev.size() != cur.size() || prev.type() != cur.type()
+					|| prev.data == cur.data || m_damage_cols * ((cur.rows + tile_rows - 1) / tile_rows) != (int)m_damage.size()) {
+					//nothing to compare with (or same buffer written in place)
+					m_damage.clear();
+					return;
+				}
+				diff_tiles(prev, cur, Size(m_damage_tile_size, tile_rows), m_damage, m_damage_cols);
 			}
 
 			/**
-			get location of mouse corrospond to the locaition of Mat
+			drop values / colors of changed tiles (all of them if frames were not compared), update m_damage_fraction
 			**/
-			template<typename T_Src, typename T_Res>
-			inline void loc_to_mouse(const Point2f& center, const float& scale_factor, const Point_<T_Src>& src, Point_<T_Res>& res) {
-				loc_to_mouse<T_Src, T_Res>(center, scale_factor, src.x, src.y, res.x, res.y);
+			inline void invalidate_damage() {
+				if (m_damage.empty()) {
+					reset_txts();
+					if (m_raw_mode) {
+						m_color_tiles_ready.assign(m_color_tiles.size(), 0);
+					}
+					m_damage_fraction = 1.f;
+					return;
+				}
+				size_t area = 0;
+				for (int ty = 0, tiles_rows = (int)m_damage.size() / m_damage_cols; ty < tiles_rows; ++ty) {
+					for (int tx = 0; tx < m_damage_cols; ++tx) {
+						if (!m_damage[ty * m_damage_cols + tx]) continue;
+						Rect rect = Rect(tx * m_damage_tile_size, ty * m_damage_tile_size, m_damage_tile_size, m_damage_tile_size) & Rect(Point(0, 0), m_org_size);
+						area += rect.area();
+						m_txt_tiles[(ty * m_damage_tile_size / m_txt_tile_size) * m_txt_tiles_cols + tx * m_damage_tile_size / m_txt_tile_size].reset();
+						if (m_raw_mode) {
+							m_color_tiles_ready[(ty * m_damage_tile_size / m_color_tile_size) * m_color_tiles_cols + tx * m_damage_tile_size / m_color_tile_size] = 0;
+						}
+					}
+				}
+				m_damage_fraction = (float)((double)area / max((double)m_org_size.area(), 1.));
 			}
 
-
 			/**
-			get location of mouse corrospond to the locaition of Mat
+			render window regions covering changed tiles of a new frame (view / texts unchanged), runs of changed tiles of a row are merged
 			**/
-			template<typename T_Src, typename T_Res>
-			inline void loc_to_mouse(const Point_<T_Src>& src, Point_<T_Res>& res) {
-				loc_to_mouse<T_Src, T_Res>(m_center, m_scale_factor, src.x, src.y, res.x, res.y);
+			inline void render_damage() {
+				register float roi_w, roi_h, roi_x, roi_y, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h;
+				cal_roi(m_center, m_scale_factor, roi_x, roi_y, roi_w, roi_h, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h);
+				Rect win_rect(Point(0, 0), m_win_size);
+				const int rects_max = 64;
+				s_arena::s_scope scope(m_arena);
+				Rect* rects = m_arena.alloc_arr<Rect>(rects_max);
+				int rects_cnt = 0, area = 0;
+				for (int ty = 0, tiles_rows = (int)m_damage.size() / m_damage_cols; ty < tiles_rows && rects_cnt <= rects_max; ++ty) {
+					for (int tx = 0; tx < m_damage_cols; ++tx) {
+						if (!m_damage[ty * m_damage_cols + tx]) continue;
+						int tx_end = tx + 1;
+						while (tx_end < m_damage_cols && m_damage[ty * m_damage_cols + tx_end]) ++tx_end;
+						//one pixel of margin: pixels around the run are rendered again (rounding of maps)
+						int x0 = (int)floor((tx * m_damage_tile_size - roi_x) * win_w_div_roi_w) - 1;
+						int x1 = (int)ceil((min(tx_end * m_damage_tile_size, m_org_size.width) - roi_x) * win_w_div_roi_w) + 1;
+						int y0 = (int)floor((ty * m_damage_tile_size - roi_y) * win_h_div_roi_h) - 1;
+						int y1 = (int)ceil((min((ty + 1) * m_damage_tile_size, m_org_size.height) - roi_y) * win_h_div_roi_h) + 1;
+						Rect rect = Rect(Point(x0, y0), Point(x1, y1)) & win_rect;
+						tx = tx_end;
+						if (rect.area() == 0) continue;
+						if (rects_cnt > 0 && rects[rects_cnt - 1].x == rect.x && rects[rects_cnt - 1].width == rect.width && rects[rects_cnt - 1].br().y >= rect.y) {
+							//same columns as the run of previous row
+							area -= rects[rects_cnt - 1].area();
+							rects[rects_cnt - 1] |= rect;
+						}
+						else if (rects_cnt < rects_max) {
+							rects[rects_cnt++] = rect;
+						}
+						else {
+							++rects_cnt;
+							break;
+						}
+						area += rects[rects_cnt - 1].area();
+					}
+				}
+				if (rects_cnt > rects_max || area * 2 > win_rect.area()) {
+					//damage is scattered / large: one render of whole window is cheaper
+					set_roi(m_center, m_scale_factor);
+					return;
+				}
+				for (int i = 0; i < rects_cnt; ++i) {
+					render_view(rects[i], chrono::steady_clock::time_point::max());
+				}
+				draw_decorations();
+				update_tiptool(m_tiptool_loc, true);
 			}
 
+			static inline chrono::steady_clock::time_point deadline_of(const chrono::steady_clock::time_point& start, const int& budget_ms) {
+				return budget_ms > 0 ? start + chrono::milliseconds(budget_ms) : chrono::steady_clock::time_point::max();
+			}
 
 			/**
-			redraw when center or scale_factor changed
+			render texts of cells left until deadline (batches of rows in parallel, deadline is checked between batches)
+			@param job [in,out] cells left
+			@param deadline [in] deadline
+			@param res [in,out] view or a rect of it
+			@param offset [in] location of res in view
+			@return whether cells are left
 			**/
-			inline void set_roi(const Point2f& center, const float& scale_factor) {
-				m_center = center;
-				m_scale_factor = scale_factor;
-
-				//register float win_w = (float)m_win_size.width, win_h = (float)m_win_size.height;
+			inline bool render_grid_txts(s_grid_txts& job, const chrono::steady_clock::time_point& deadline, Mat& res, const Point& offset) {
 				register float roi_w, roi_h, roi_x, roi_y, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h;
 				cal_roi(m_center, m_scale_factor, roi_x, roi_y, roi_w, roi_h, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h);
-				const int v_channels = 3;
-				assert(m_colored.channels() == v_channels);
-				register int w = m_win_size.width, h = m_win_size.height, wo = m_org_size.width, ho = m_org_size.height;
-				if (m_colored_vis.size() != m_win_size) {
-					m_colored_vis = Mat::zeros(m_win_size, CV_8UC3);
-				}
-				else {
-					m_colored_vis.setTo(0);
-				}
-				//
-				{
-					u8* p_colored_vis_head = (u8*)m_colored_vis.data;
-					u8* p_colored_head = (u8*)m_colored.data;
-
-					int* p_yos = new int[h], * p_xos = new int[w];
-					register int yos_min_threshold = 0 * (wo * v_channels), yos_max_threshold = ho * (wo * v_channels), xos_min_threshold = 0 * v_channels, xos_max_threshold = wo * (v_channels);
-					register int x_start = 0, x_end = 0, y_start = 0, y_end = 0;
-					for (x_end = 0; x_end < w; ++x_end) {
-						p_xos[x_end] = (int)floor(roi_x + roi_w_div_win_w * x_end) * v_channels;
-						if (p_xos[x_end] < xos_min_threshold) ++x_start;
-						else if (p_xos[x_end] >= xos_max_threshold) break;
-					}
-					for (y_end = 0; y_end < h; ++y_end) {
-						p_yos[y_end] = (int)floor(roi_y + roi_h_div_win_h * y_end) * (wo * v_channels);
-						if (p_yos[y_end] < yos_min_threshold) ++y_start;
-						else if (p_yos[y_end] >= yos_max_threshold) break;
-					}
+				int x_start = job.x_start, x_end = job.x_end;
+				while (job.y_next < job.y_end && chrono::steady_clock::now() < deadline) {
+					int y_start = job.y_next, y_end = min(job.y_end, job.y_next + emat_omp_cnt);
+					prepare_txts(x_start, x_end, y_start, y_end);
 #ifdef _OPENMP
-#pragma omp parallel for num_threads(emat_omp_cnt)
+#pragma omp parallel for num_threads(emat_omp_cnt) schedule(dynamic)
 #endif
-					emat_omp{
-						u8 * p_colored_vis = 0, *p_colored = 0;
-						for (int y = emat_omp_offset_range(y_start, y_end), y_len = emat_omp_offset_next_range(y_start, y_end), x = 0; y < y_len; ++y) {
-							p_colored_vis = p_colored_vis_head + ((y * w + x_start) * v_channels);
-							p_colored = p_colored_head + p_yos[y];
-							for (x = x_start; x < x_end; ++x, p_colored_vis += v_channels) {
-								memcpy(p_colored_vis, p_colored + p_xos[x], v_channels);
-							}
+					for (int y = y_start; y < y_end; ++y) {
+						Point2i txt_loc;
+						s_val_txts* txts;
+						Size txts_size;
+						const u8* bg_color;
+						for (int x = x_start; x < x_end; ++x) {
+							raw_val_to_txt(x, y, txts);
+							bg_color = colored_px(x, y);
+							get_txts_size(*txts, m_val_font_face, m_val_font_scale, m_val_font_thickness, txts_size);
+							txt_loc.x = (int)round((x + 0.5f - roi_x) * win_w_div_roi_w) - txts_size.width / 2;
+							txt_loc.y = (int)round((y + 0.5f - roi_y) * win_h_div_roi_h) + txts_size.height / 2;
+							put_txts(*txts, txt_loc - offset, m_val_font_face, m_val_font_scale, Scalar::all((bg_color[0] + bg_color[1] + bg_color[2] > 127 * 3) ? 0 : 255), m_val_font_thickness, res);
 						}
 					}
-					delete[] p_yos;
-					delete[] p_xos;
+					job.y_next = y_end;
 				}
-				//
-				{
-#define x_to_win(x) ((x - roi_x) * win_w_div_roi_w)
-#define y_to_win(y) ((y - roi_y) * win_h_div_roi_h)
+				return job.y_next < job.y_end;
+			}
 
-					int top_to_win = (int)round(y_to_win(0)), bottom_to_win = (int)round(y_to_win(m_org_size.height)),
-						left_to_win = (int)round(x_to_win(0)), right_to_win = (int)round(x_to_win(m_org_size.width));
-					m_grid_view_mode = m_val_font_max_size.width <= ((float)m_win_size.width / roi_w) && m_val_font_max_size.height <= ((float)m_win_size.height / roi_h);
-					if (m_grid_view_mode) 
-					{
-						int y_start = max(0, (int)(roi_y - 1)), y_end = min(ho, (int)(roi_y + roi_h + 2));
-						int x_start = max(0, (int)(roi_x - 1)), x_end = min(wo, (int)(roi_x + roi_w + 2));
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(emat_omp_cnt)
-#endif
-						for (int i = x_start; i <= x_end; ++i) {
-							auto x_pos = (int)round(x_to_win(i));
-							line(m_colored_vis, Point(x_pos, top_to_win), Point(x_pos, bottom_to_win), m_grid_color, m_grid_thickness);
-						}
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(emat_omp_cnt)
-#endif
-						for (int i = y_start; i <= y_end; ++i) {
-							auto y_pos = (int)round(y_to_win(i));
-							line(m_colored_vis, Point(left_to_win, y_pos), Point(right_to_win, y_pos), m_grid_color, m_grid_thickness);
-						}
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(emat_omp_cnt)
-#endif
-						emat_omp{
-							Point2i txt_loc;
-							vector<string>* txts;
-							Size txts_size;
-							u8* bg_color;
-							for (int y = emat_omp_offset_range(y_start, y_end), y_len = emat_omp_offset_next_range(y_start, y_end), x = 0; y < y_len; ++y) {
-								for (x = x_start; x < x_end; ++x) {
-									raw_val_to_txt(x, y, txts);
-									bg_color = m_colored.at<Vec3b>(y, x).val;
-									get_txts_size(*txts, m_val_font_face, m_val_font_scale, m_val_font_thickness, txts_size);
-									txt_loc.x = (int)round(x_to_win(x + 0.5f)) - txts_size.width / 2;
-									txt_loc.y = (int)round(y_to_win(y + 0.5f)) + txts_size.height / 2;
-									put_txts(*txts, txt_loc, m_val_font_face, m_val_font_scale, Scalar::all((bg_color[0] + bg_color[1] + bg_color[2] > 127 * 3) ? 0 : 255), m_val_font_thickness, m_colored_vis);
-								}
+			/**
+			rasterize m_colored_txts into sparse overlays (coverage + color per bounding rect)
+			**/
+			inline void build_txt_overlays() {
+				m_txt_overlays.clear();
+				Rect win_rect(Point(0, 0), m_win_size);
+				Size txt_size;
+				for (auto& txt : m_colored_txts) {
+					get_txt_size(txt.text, txt.font_face, txt.font_scale, txt.font_thickness, txt_size);
+					Point2i loc(txt.loc.x + (int)round(txt.font_offset.x * txt_size.width + txt.win_offset.x * m_win_size.width),
+						txt.loc.y + (int)round(txt.font_offset.y * txt_size.height + txt.win_offset.y * m_win_size.height));
+					int baseline = 0, pad = txt.font_thickness + 1;
+					Size glyph_size = getTextSize(txt.text, txt.font_face, txt.font_scale, txt.font_thickness, &baseline);
+					//see put_txt for the origin of glyphs
+					Rect rect(loc.x - pad, loc.y - 2 - glyph_size.height - pad, glyph_size.width + 2 * pad, glyph_size.height + baseline + 2 * pad);
+					Rect clipped = rect & win_rect;
+					if (clipped.area() == 0) continue;
+					//coverage is rasterized into an arena mat, mask / color of overlay are expanded from it in one pass
+					s_arena::s_scope scope(m_arena);
+					Mat coverage;
+					coverage.allocator = &m_arena_allocator;
+					coverage.create(rect.size(), CV_8U);
+					coverage.setTo(0);
+					put_txt(txt.text, loc - rect.tl(), txt.font_face, txt.font_scale, Scalar::all(255), txt.font_thickness, coverage);
+					s_txt_overlay overlay;
+					overlay.rect = clipped;
+					overlay.mask.create(clipped.size(), CV_8UC3);
+					overlay.color.create(clipped.size(), CV_8UC3);
+					u8 color[3] = { saturate_cast<u8>(txt.font_color[0]), saturate_cast<u8>(txt.font_color[1]), saturate_cast<u8>(txt.font_color[2]) };
+					for (int y = 0; y < clipped.height; ++y) {
+						auto p_coverage = coverage.ptr<u8>(clipped.y - rect.y + y) + clipped.x - rect.x;
+						auto p_mask = overlay.mask.ptr<u8>(y);
+						auto p_color = overlay.color.ptr<u8>(y);
+						for (int x = 0; x < clipped.width; ++x) {
+							for (int c = 0; c < 3; ++c) {
+								p_mask[x * 3 + c] = p_coverage[x];
+								p_color[x * 3 + c] = p_coverage[x] & color[c];
 							}
 						}
 					}
-					else {
-						rectangle(m_colored_vis, Rect(Point2i(left_to_win - 1, top_to_win - 1), Point2i(right_to_win + 1, bottom_to_win + 1)), m_grid_color, m_grid_thickness);
-					}
-#undef x_to_win
-#undef y_to_win
+					m_txt_overlays.emplace_back(overlay);
 				}
-				if (m_colored_txts.size() > 0) {
-					Size txt_size;
-					for (auto& txt : m_colored_txts) {
-						get_txt_size(txt.text, txt.font_face, txt.font_scale, txt.font_thickness, txt_size);
-						put_txt(txt.text,
-							Point2i(txt.loc.x + (int)round(txt.font_offset.x * txt_size.width + txt.win_offset.x * m_win_size.width),
-								txt.loc.y + (int)round(txt.font_offset.y * txt_size.height + txt.win_offset.y * m_win_size.height)),
-							txt.font_face, txt.font_scale, txt.font_color, txt.font_thickness, m_colored_vis);
+				m_txt_overlays_size = m_win_size;
+			}
+
+			/**
+			composite overlays onto a rendered view (bytewise select, limited to their rects)
+			**/
+			inline void composite_txt_overlays(Mat& res) const {
+				for (auto& overlay : m_txt_overlays) {
+					register int len = overlay.rect.width * 3;
+					for (int y = 0; y < overlay.rect.height; ++y) {
+						register auto p_res = res.ptr<u8>(overlay.rect.y + y) + overlay.rect.x * 3;
+						register auto p_mask = overlay.mask.ptr<u8>(y);
+						register auto p_color = overlay.color.ptr<u8>(y);
+						for (int i = 0; i < len; ++i) {
+							p_res[i] = (u8)((p_res[i] & ~p_mask[i]) | p_color[i]);
+						}
 					}
 				}
-				//draw box
-				if (m_box_en) {
-					int  box_size_w = 0, box_size_h = 0;
-					if (m_org_size.width > m_org_size.height) {
-						box_size_w = m_box_size;
-						box_size_h = box_size_w * m_org_size.height / m_org_size.width;
+			}
+
+			/**
+			colorize tiles covering [x0, x1] x [y0, y1] of raw which are not colorized yet
+			**/
+			inline void prepare_color_tiles(const int& x0, const int& x1, const int& y0, const int& y1) {
+				int tx0 = max(x0, 0) / m_color_tile_size, tx1 = min(x1, m_raw.cols - 1) / m_color_tile_size;
+				int ty0 = max(y0, 0) / m_color_tile_size, ty1 = min(y1, m_raw.rows - 1) / m_color_tile_size;
+				for (int ty = ty0; ty <= ty1; ++ty) {
+					for (int tx = tx0; tx <= tx1; ++tx) {
+						int idx = ty * m_color_tiles_cols + tx;
+						if (m_color_tiles_ready[idx]) continue;
+						Rect rect = Rect(tx * m_color_tile_size, ty * m_color_tile_size, m_color_tile_size, m_color_tile_size) & Rect(0, 0, m_raw.cols, m_raw.rows);
+						m_color_tiles[idx].create(rect.size(), CV_8UC3);
+						if (m_policy.m_format == vis_format_values) {
+							vis_colorize(m_raw(rect), m_policy, m_color_tiles[idx]);
+						}
+						else {
+							//native formats need the whole frame (neighbors / UV plane): convert through identity maps
+							s_arena::s_scope scope(m_arena);
+							auto p_xs = m_arena.alloc_arr<int>(rect.width);
+							auto p_ys = m_arena.alloc_arr<int>(rect.height);
+							for (int i = 0; i < rect.width; ++i) p_xs[i] = rect.x + i;
+							for (int i = 0; i < rect.height; ++i) p_ys[i] = rect.y + i;
+							vis_colorize_sampled(m_raw, m_policy, p_xs, 0, rect.width, p_ys, 0, rect.height, m_color_tiles[idx]);
+						}
+						m_color_tiles_ready[idx] = 1;
+					}
+				}
+			}
+
+			/**
+			get color of a pixel of raw (tile must be prepared in raw-only mode)
+			**/
+			inline const u8* colored_px(const int& x, const int& y) const {
+				if (m_raw_mode) {
+					return m_color_tiles[(y / m_color_tile_size) * m_color_tiles_cols + x / m_color_tile_size].ptr<u8>(y % m_color_tile_size) + (x % m_color_tile_size) * 3;
+				}
+				return m_colored.ptr<u8>(y) + x * 3;
+			}
+			Mat m_native;									//whole buffer of native formats (m_raw is a view of its image, e.g. Y plane of NV12)
+			Mat m_colored_vis;
+			s_arena m_arena;								//scratch buffers of render paths (released at end of each render)
+			s_arena_mat_allocator m_arena_allocator;		//temporary mats backed by m_arena
+		public:
+			string m_win_name;
+			Mat m_colored;
+			Mat m_colored_vis_tiptool;
+			vector<s_viewer_text> m_colored_txts;
+			Mat m_raw;
+			Point2f m_center;
+			float m_scale_factor;
+			u64 m_idx;
+			Size m_win_size;
+			Size m_org_size;
+			float m_val_font_scale = 0.34f;
+			int m_val_font_thickness = 1;
+			int m_val_font_face = (int)FONT_HERSHEY_SIMPLEX;
+			Scalar m_tiptool_font_color = Scalar::all(255);
+			int m_tiptool_font_face = (int)FONT_HERSHEY_SIMPLEX;
+			float m_tiptool_font_scale = 0.5f;
+			int m_tiptool_font_thickness = 2;
+			Scalar m_grid_color = Scalar::all(200);
+			int m_grid_thickness = 1;
+			Point2f m_tiptool_loc = Point2f(-1.f, -1.f);
+			bool m_grid_view_mode = false;
+			Size m_val_font_max_size;
+			int m_box_margin = 10;
+			int m_box_size = 200;
+			Scalar m_box_color = Scalar::all(255);
+			int m_box_thickness = 2;
+			bool m_box_en = false;
+			Mat m_box_thumb;					//overview thumbnail of current frame (halved)
+			bool m_box_thumb_valid = false;
+			int m_val_precision = 3;			//decimals of floating point values, -1: shortest text
+			double m_val_min = 0.;
+			double m_val_max = 0.;
+			void* m_tag;
+			bool m_dirty_roi = false;						//view changed, not rendered yet (see flush)
+			int m_frame_budget_ms = -1;						//budget of renders triggered by mouse events (ms), -1: refresh interval of viewer, 0: unlimited
+			bool m_damage_tracking = true;					//new frames are compared with the current one, only changed regions are rendered
+			float m_damage_fraction = 1.f;					//changed area of last frame / area of frame (1: not compared)
+			bool m_dirty_tiptool = false;
+			Point2f m_pending_tiptool_loc = Point2f(-1.f, -1.f);
+			chrono::steady_clock::time_point m_last_render;
+			chrono::steady_clock::time_point m_last_event;	//last mouse event (bursts are coalesced, see render_pending)
+			chrono::steady_clock::time_point m_last_view = chrono::steady_clock::now();	//last interaction / show (order of eviction)
+			i64 m_shown_idx = -1;							//index of frame of the last imgs_show which showed the window
+
+			s_cache_display(const string& win_name, const Size& win_size, const int& val_precision)
+				: m_arena_allocator(&m_arena)
+			{
+				m_win_name = win_name;
+				m_win_size = win_size;
+				m_val_precision = val_precision;
+				m_center = Point2f(0.f, 0.f);
+				m_scale_factor = 1.f;
+				m_idx = 0;
+			}
+
+			/**
+			ingest a new frame (buffers are reused, view is kept if size of frame did not change)
+			@param colored [in] image to display (CV_8UC3)
+			@param raw [in] image with related values (same size with colored)
+			@param idx [in] index of frame
+			@param txts [in] texts will be rendered on screen
+			@param shared [in] reference colored / raw instead of copying them (caller must not write into them afterwards)
+			@return
+			**/
+			inline void set_frame(const Mat& colored, const Mat& raw, const  u64& idx, const vector<s_viewer_text>& txts, const bool& shared = false)
+			{
+				assert(colored.size() == raw.size());
+				diff_frame(m_colored, colored, true);
+				diff_frame(m_raw, raw, false);
+				clear_stack();
+				release_shared(shared);
+				if (shared) {
+					m_colored = colored;
+				}
+				else {
+					colored.copyTo(m_colored);
+				}
+				m_raw_mode = false;
+				m_native.release();
+				set_frame_(raw, idx, txts);
+			}
+
+			/**
+			ingest a new raw frame, only pixels sampled by the view are colorized (by policy)
+			@param raw [in] single channel image with values
+			@param policy [in] color map / range, range state (running / percentile) is kept while mode and color map do not change
+			@param idx [in] index of frame
+			@param txts [in] texts will be rendered on screen
+			@param shared [in] reference raw instead of copying it (caller must not write into it afterwards)
+			@return
+			**/
+			inline void set_frame(const Mat& raw, const s_vis_policy& policy, const  u64& idx, const vector<s_viewer_text>& txts, const bool& shared = false)
+			{
+				assert(raw.channels() == 1);
+				bool same_policy = m_raw_mode && m_policy.m_colormap == policy.m_colormap && m_policy.m_lut == policy.m_lut && m_policy.m_range.m_mode == policy.m_range.m_mode
+					&& m_policy.m_format == policy.m_format && m_policy.m_bits == policy.m_bits;
+				//compared before buffers are released / overwritten
+				if (policy.m_format == vis_format_values) {
+					diff_frame(m_raw, raw, true);
+				}
+				else if (policy.m_format == vis_format_nv12 && !m_native.empty()) {
+					int rows = raw.rows * 2 / 3;
+					diff_frame(m_native.rowRange(0, min(rows, m_native.rows)), raw.rowRange(0, rows), true);
+					diff_frame(m_native.rowRange(min(rows, m_native.rows), m_native.rows), raw.rowRange(rows, raw.rows), false, m_damage_tile_size / 2);
+				}
+				else {
+					diff_frame(m_native, raw, true);
+				}
+				if (!same_policy) {
+					m_damage.clear();
+				}
+				double range_min = m_policy.m_range.m_min, range_max = m_policy.m_range.m_max;
+				clear_stack();
+				release_shared(shared);
+				if (same_policy && policy.m_range.m_mode != s_vis_range::range_fixed) {
+					m_policy.m_nan_color = policy.m_nan_color;
+				}
+				else {
+					m_policy = policy;
+				}
+				m_colored.release();
+				m_raw_mode = true;
+				Mat img = raw;
+				if (policy.m_format == vis_format_values) {
+					m_policy.update_range(raw);
+					m_native.release();
+				}
+				else {
+					//the whole buffer is kept, values / colors are read from it by format (no conversion pass)
+					if (shared) {
+						m_native = raw;
+					}
+					else {
+						raw.copyTo(m_native);
+					}
+					img = vis_format_image(m_native, policy.m_format);
+				}
+				if (m_policy.m_range.m_min != range_min || m_policy.m_range.m_max != range_max) {
+					//colors of all pixels changed
+					m_damage.clear();
+				}
+				//tiles are colorized again on access (changed tiles only, see invalidate_damage)
+				int tiles_cols = (img.cols + m_color_tile_size - 1) / m_color_tile_size, tiles_rows = (img.rows + m_color_tile_size - 1) / m_color_tile_size;
+				if (m_color_tiles_cols != tiles_cols || (int)m_color_tiles.size() != tiles_cols * tiles_rows) {
+					m_color_tiles.assign(tiles_cols * tiles_rows, Mat());
+					m_color_tiles_cols = tiles_cols;
+					m_color_tiles_ready.assign(m_color_tiles.size(), 0);
+					m_damage.clear();
+				}
+				set_frame_(img, idx, txts, policy.m_format != vis_format_values);
+			}
+
+			/**
+			ingest a stack of slices (raw values, colorized by policy), the stack is referenced (no copy),
+			the current slice is kept while the same stack is given again
+			@param volume [in] N-D source of slices (keeps their data alive, may be empty if slices own their data)
+			@param slices [in] 2D single channel views of same size / type
+			@param policy [in] color map / range
+			@param idx [in] index of frame
+			@param txts [in] texts will be rendered on screen
+			@return
+			**/
+			inline void set_stack(const Mat& volume, const vector<Mat>& slices, const s_vis_policy& policy, const  u64& idx, const vector<s_viewer_text>& txts)
+			{
+				assert(slices.size() > 0);
+				bool same = m_slices.size() == slices.size() && m_slices.front().data == slices.front().data && m_slices.back().data == slices.back().data
+					&& m_slices.front().size() == slices.front().size() && m_slices.front().type() == slices.front().type();
+				//a changed policy colorizes the current slice again (range state is kept as in set_frame)
+				same = same && m_policy.m_colormap == policy.m_colormap && m_policy.m_lut == policy.m_lut && m_policy.m_range.m_mode == policy.m_range.m_mode
+					&& m_policy.m_format == policy.m_format && m_policy.m_bits == policy.m_bits && m_policy.m_nan_color == policy.m_nan_color
+					&& (policy.m_range.m_mode != s_vis_range::range_fixed || (m_policy.m_range.m_min == policy.m_range.m_min && m_policy.m_range.m_max == policy.m_range.m_max));
+				if (same) {
+					m_idx = idx;
+					bool txts_changed = m_stack_txts.size() != txts.size();
+					for (size_t i = 0; !txts_changed && i < txts.size(); ++i) {
+						txts_changed = m_stack_txts[i].text != txts[i].text;
+					}
+					if (txts_changed) {
+						m_stack_txts = txts;
+						m_colored_txts = stack_txts(m_slice_idx, (int)m_slices.size());
+						m_txt_overlays_size = Size();
+						m_dirty_roi = true;
+					}
+					return;
+				}
+				int slice_idx = m_slices.size() == slices.size() ? m_slice_idx : 0;
+				m_stack_txts = txts;
+				set_frame(slices[slice_idx], policy, idx, stack_txts(slice_idx, (int)slices.size()), true);
+				m_stack = volume;
+				m_slices = slices;
+				m_slice_idx = slice_idx;
+				launch_prefetch();
+			}
+
+			/**
+			select slice of stack (statistics / view of neighbors are prefetched, rendered by flush)
+			**/
+			inline void set_slice(const int& idx) {
+				if (m_slices.size() == 0) return;
+				int idx_new = min(max(idx, 0), (int)m_slices.size() - 1);
+				if (idx_new == m_slice_idx) return;
+				s_slice_prefetch prefetch;
+				for (int k = 0; k < 2; ++k) {
+					//a prefetch still running is left to finish (launch_prefetch skips its slot), UI does not wait for it
+					if (m_prefetch_idx[k] == idx_new && m_prefetch[k].valid() && m_prefetch[k].wait_for(chrono::seconds(0)) == future_status::ready) {
+						prefetch = m_prefetch[k].get();
+						m_prefetch_idx[k] = -1;
+					}
+				}
+				if (prefetch.idx != idx_new) {
+					prefetch = prefetch_slice(m_slices[idx_new], idx_new, m_policy, m_maps->m_xos, m_maps->m_yos, m_win_size, false);
+				}
+				m_slice_idx = idx_new;
+				m_raw = m_slices[idx_new];
+				m_policy.m_range.update(prefetch.frame_min, prefetch.frame_max);
+				m_val_min = prefetch.val_min;
+				m_val_max = prefetch.val_max;
+				update_val_font_size();
+				reset_txts();
+				m_color_tiles_ready.assign(m_color_tiles.size(), 0);
+				m_box_thumb_valid = false;
+				m_colored_txts = stack_txts(m_slice_idx, (int)m_slices.size());
+				m_txt_overlays_size = Size();
+				m_slice_base = prefetch.base;
+				m_slice_base_key = prefetch.base_key;
+				m_dirty_roi = true;
+				launch_prefetch();
+			}
+
+			inline int slice_idx() const {
+				return m_slice_idx;
+			}
+
+			inline int slices_cnt() const {
+				return (int)m_slices.size();
+			}
+
+			/**
+			buffers which reference frames of caller must not be written into (copyTo would reuse them)
+			**/
+			inline void release_shared(const bool& shared) {
+				if (m_shared || shared) {
+					m_colored.release();
+					m_raw.release();
+					m_native.release();
+				}
+				m_shared = shared;
+			}
+
+			inline void set_frame_(const Mat& raw, const  u64& idx, const vector<s_viewer_text>& txts, const bool& native = false)
+			{
+				bool keep_view = m_org_size == raw.size();
+				bool keep_txts = same_txts(m_colored_txts, txts);
+				m_org_size = raw.size();
+
+				if (m_shared || native) {
+					m_raw = raw;
+				}
+				else {
+					raw.copyTo(m_raw);
+				}
+
+				m_idx = idx;
+				if (!keep_txts) {
+					m_colored_txts = txts;
+					m_txt_overlays_size = Size();
+				}
+				m_box_thumb_valid = false;
+				m_fmt_fn = native ? native_fmt_fn(m_policy.m_format, m_raw.depth()) : depth_dispatch<s_fmt_kernel>::get(m_raw.depth());
+				if (!keep_view) {
+					m_damage.clear();
+				}
+				invalidate_damage();
+				Size val_font_max_size = m_val_font_max_size;
+				scan_val_range();
+				update_val_font_size();
+				if (!keep_view) {
+					m_tiptool_loc = Point2f(-1.f, -1.f);
+					m_box_en = false;
+				}
+				if (m_damage.size() > 0 && keep_txts && val_font_max_size == m_val_font_max_size && !m_dirty_roi
+					&& m_grid_txts.y_next >= m_grid_txts.y_end && m_colored_vis.size() == m_win_size) {
+					//same view of a partially changed frame
+					render_damage();
+				}
+				else {
+					set_roi(keep_view ? m_center : Point2f((float)m_org_size.width / 2, (float)m_org_size.height / 2), keep_view ? m_scale_factor : 1.f);
+				}
+			}
+
+			/**
+			whether subtitles are the same (overlays are kept)
+			**/
+			static inline bool same_txts(const vector<s_viewer_text>& a, const vector<s_viewer_text>& b) {
+				if (a.size() != b.size()) return false;
+				for (size_t i = 0; i < a.size(); ++i) {
+					if (a[i].text != b[i].text || a[i].loc != b[i].loc || a[i].font_face != b[i].font_face || a[i].font_scale != b[i].font_scale
+						|| a[i].font_thickness != b[i].font_thickness || a[i].font_color != b[i].font_color || a[i].font_offset != b[i].font_offset || a[i].win_offset != b[i].win_offset) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			/**
+			min / max of values (size of texts, see minmax_sampled)
+			**/
+			inline void scan_val_range() {
+				minmax_sampled(m_raw, m_val_min, m_val_max);
+			}
+
+			~s_cache_display() {
+				clear_stack();
+			}
+
+			/**
+			calculate the max text size of values in Mat
+			**/
+			inline void update_val_font_size() {
+				s_val_txts widest_txts;
+				if (m_raw_mode && m_policy.m_format != vis_format_values) {
+					//labeled integers of native formats, e.g. "Y:255" / "R:1023"
+					fmt_int_labeled('G', m_policy.m_format == vis_format_nv12 ? 255 : (i64)max(fabs(m_val_min), fabs(m_val_max)), widest_txts.txts[0]);
+					widest_txts.cnt = m_policy.m_format == vis_format_nv12 ? 3 : 1;
+				}
+				else {
+					fmt_widest(m_raw.depth(), m_val_min, m_val_max, m_val_precision, widest_txts.txts[0]);
+					widest_txts.cnt = (u8)min(m_raw.channels(), (int)s_val_txts::capacity);
+				}
+				for (int i = 1; i < widest_txts.cnt; ++i) {
+					widest_txts.txts[i] = widest_txts.txts[0];
+				}
+				get_txts_size(widest_txts, m_val_font_face, m_val_font_scale, m_val_font_thickness, m_val_font_max_size);
+				m_val_font_max_size.width += 4;
+				m_val_font_max_size.height += 4;
+			}
+
+			/**
+			set precision of values
+			@param precision [in] decimals of floating point values, -1: shortest text
+			@return
+			**/
+			inline void set_val_precision(const int& precision) {
+				if (precision == m_val_precision) return;
+				m_val_precision = precision;
+				reset_txts();
+				update_val_font_size();
+				set_roi(m_center, m_scale_factor);
+			}
+
+			/**
+			set color of font
+			**/
+			inline void set_tiptool_color(const Scalar& font_color) {
+				m_tiptool_font_color = font_color;
+			}
+
+			/**
+			get location of Mat corrospond to the locaition of mouse
+			**/
+			template<typename T_Src, typename T_Res>
+			inline void loc_from_mouse(const Point2f& center, const float& scale_factor, const T_Src& src_x, const T_Src& src_y, T_Res& res_x, T_Res& res_y) {
+				float roi_w, roi_h, roi_x, roi_y, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h;
+				cal_roi(center, scale_factor, roi_x, roi_y, roi_w, roi_h, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h);
+				res_x = (T_Res)(roi_x + src_x * roi_w_div_win_w);
+				res_y = (T_Res)(roi_y + src_y * roi_h_div_win_h);
+			}
+
+			/**
+			get location of Mat corrospond to the locaition of mouse
+			**/
+			template<typename T_Src, typename T_Res>
+			inline void loc_from_mouse(const T_Src& src_x, const T_Src& src_y, T_Res& res_x, T_Res& res_y) {
+				loc_from_mouse<T_Src, T_Res>(m_center, m_scale_factor, src_x, src_y, res_x, res_y);
+			}
+
+			/**
+			get location of Mat corrospond to the locaition of mouse
+			**/
+			template<typename T_Src, typename T_Res>
+			inline void loc_from_mouse(const Point2f& center, const float& scale_factor, const Point_<T_Src>& src, Point_<T_Res>& res) {
+				loc_from_mouse<T_Src, T_Res>(center, scale_factor, src.x, src.y, res.x, res.y);
+			}
+
+			/**
+			get location of Mat corrospond to the locaition of mouse
+			**/
+			template<typename T_Src, typename T_Res>
+			inline void loc_from_mouse(const Point_<T_Src>& src, Point_<T_Res>& res) {
+				loc_from_mouse<T_Src, T_Res>(m_center, m_scale_factor, src.x, src.y, res.x, res.y);
+			}
+
+			/**
+			get location of mouse corrospond to the locaition of Mat
+			**/
+			template<typename T_Src, typename T_Res>
+			inline void loc_to_mouse(const Point2f& center, const float& scale_factor, const T_Src& src_x, const T_Src& src_y, T_Res& res_x, T_Res& res_y) {
+				float roi_w, roi_h, roi_x, roi_y, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h;
+				cal_roi(center, scale_factor, roi_x, roi_y, roi_w, roi_h, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h);
+				res_x = (T_Res)((src_x - roi_x) * win_w_div_roi_w);
+				res_y = (T_Res)((src_y - roi_y) * win_h_div_roi_h);
+			}
+
+			/**
+			get location of mouse corrospond to the locaition of Mat
+			**/
+			template<typename T_Src, typename T_Res>
+			inline void loc_to_mouse(const T_Src& src_x, const T_Src& src_y, T_Res& res_x, T_Res& res_y) {
+				loc_to_mouse<T_Src, T_Res>(m_center, m_scale_factor, src_x, src_y, res_x, res_y);
+			}
+
+			/**
+			get location of mouse corrospond to the locaition of Mat
+			**/
+			template<typename T_Src, typename T_Res>
+			inline void loc_to_mouse(const Point2f& center, const float& scale_factor, const Point_<T_Src>& src, Point_<T_Res>& res) {
+				loc_to_mouse<T_Src, T_Res>(center, scale_factor, src.x, src.y, res.x, res.y);
+			}
+
+
+			/**
+			get location of mouse corrospond to the locaition of Mat
+			**/
+			template<typename T_Src, typename T_Res>
+			inline void loc_to_mouse(const Point_<T_Src>& src, Point_<T_Res>& res) {
+				loc_to_mouse<T_Src, T_Res>(m_center, m_scale_factor, src.x, src.y, res.x, res.y);
+			}
+
+
+			/**
+			redraw when center or scale_factor changed
+			@param center [in] center of view
+			@param scale_factor [in] scale of view
+			@param budget_ms [in] frame budget (ms): image, grid lines and overlays are always rendered, texts of cells left
+			are rendered by continue_txts in following slices, 0: render all texts now
+			@return
+			**/
+			inline void set_roi(const Point2f& center, const float& scale_factor, const int& budget_ms = 0) {
+				auto start = chrono::steady_clock::now();
+				m_center = center;
+				m_scale_factor = scale_factor;
+				m_dirty_roi = false;
+				m_grid_txts = s_grid_txts();				//texts left of previous view are dropped
+				if (m_colored_vis.size() != m_win_size) {
+					m_colored_vis = Mat::zeros(m_win_size, CV_8UC3);
+				}
+				render_view(Rect(Point(0, 0), m_win_size), deadline_of(start, budget_ms));
+				draw_decorations();
+				update_tiptool(m_tiptool_loc, true);
+			}
+
+			/**
+			render image, grid lines and texts of cells within a rect of window (other pixels are kept)
+			@param clip [in] rect of window
+			@param deadline [in] texts of cells left at deadline are rendered by continue_txts (whole window only, a rect is rendered completely)
+			@return
+			**/
+			inline void render_view(const Rect& clip, const chrono::steady_clock::time_point& deadline) {
+				bool whole = clip == Rect(Point(0, 0), m_win_size);
+				//register float win_w = (float)m_win_size.width, win_h = (float)m_win_size.height;
+				register float roi_w, roi_h, roi_x, roi_y, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h;
+				cal_roi(m_center, m_scale_factor, roi_x, roi_y, roi_w, roi_h, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h);
+				const int v_channels = 3;
+				assert(m_raw_mode || m_colored.channels() == v_channels);
+				register int w = m_win_size.width, h = m_win_size.height, wo = m_org_size.width, ho = m_org_size.height;
+				Mat vis = m_colored_vis(clip);
+				Point offset = clip.tl();
+				vis.setTo(0);
+				//
+				{
+					u8* p_colored_vis_head = (u8*)m_colored_vis.data;
+					u8* p_colored_head = (u8*)m_colored.data;
+
+					//maps of linked windows are already updated by the first one (update only reads them then)
+					auto& xos = m_maps->m_xos;
+					auto& yos = m_maps->m_yos;
+					xos.update(roi_x, roi_w_div_win_w, w, wo);
+					yos.update(roi_y, roi_h_div_win_h, h, ho);
+					const int* p_xos = xos.m_idx.data(), * p_yos = yos.m_idx.data();
+					register int x_start = max(xos.m_start, clip.x), x_end = min(xos.m_end, clip.x + clip.width), y_start = max(yos.m_start, clip.y), y_end = min(yos.m_end, clip.y + clip.height);
+					register size_t colored_step = m_colored.step, colored_vis_step = m_colored_vis.step;
+					if (m_raw_mode && roi_w * roi_h > (float)w * h) {
+						//zoomed out: colorize the sampled pixels only (cost depends on size of window)
+						if (whole && !m_slice_base.empty() && m_slice_base.size() == m_colored_vis.size()
+							&& m_slice_base_key == Vec<double, 6>(xos.m_origin, xos.m_step, yos.m_origin, yos.m_step, m_policy.m_range.m_min, m_policy.m_range.m_max)) {
+							//prefetched with same view / range (stack navigation)
+							m_slice_base.copyTo(m_colored_vis);
+						}
+						else {
+							vis_colorize_sampled(m_raw, m_policy, p_xos, x_start, x_end, p_yos, y_start, y_end, m_colored_vis);
+						}
+					}
+					else if (m_raw_mode) {
+						//zoomed in: colorize visible tiles once, and sample from them
+						if (x_start < x_end && y_start < y_end) {
+							prepare_color_tiles(p_xos[x_start], p_xos[x_end - 1], p_yos[y_start], p_yos[y_end - 1]);
+						}
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+						emat_omp{
+							u8 * p_colored_vis = 0;
+							for (int y = emat_omp_offset_range(y_start, y_end), y_len = emat_omp_offset_next_range(y_start, y_end), x = 0; y < y_len; ++y) {
+								p_colored_vis = p_colored_vis_head + y * colored_vis_step + x_start * v_channels;
+								for (x = x_start; x < x_end; ++x, p_colored_vis += v_channels) {
+									memcpy(p_colored_vis, colored_px(p_xos[x], p_yos[y]), v_channels);
+								}
+							}
+						}
+					}
+					else {
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+						emat_omp{
+							u8 * p_colored_vis = 0, *p_colored = 0;
+							for (int y = emat_omp_offset_range(y_start, y_end), y_len = emat_omp_offset_next_range(y_start, y_end), x = 0; y < y_len; ++y) {
+								p_colored_vis = p_colored_vis_head + y * colored_vis_step + x_start * v_channels;
+								p_colored = p_colored_head + p_yos[y] * colored_step;
+								for (x = x_start; x < x_end; ++x, p_colored_vis += v_channels) {
+									memcpy(p_colored_vis, p_colored + p_xos[x] * v_channels, v_channels);
+								}
+							}
+						}
+					}
+				}
+				//
+				{
+#define x_to_win(x) ((x - roi_x) * win_w_div_roi_w)
+#define y_to_win(y) ((y - roi_y) * win_h_div_roi_h)
+
+					int top_to_win = (int)round(y_to_win(0)), bottom_to_win = (int)round(y_to_win(m_org_size.height)),
+						left_to_win = (int)round(x_to_win(0)), right_to_win = (int)round(x_to_win(m_org_size.width));
+					m_grid_view_mode = m_val_font_max_size.width <= ((float)m_win_size.width / roi_w) && m_val_font_max_size.height <= ((float)m_win_size.height / roi_h);
+					if (m_grid_view_mode) 
+					{
+						int y_start = max(0, (int)(roi_y - 1)), y_end = min(ho, (int)(roi_y + roi_h + 2));
+						int x_start = max(0, (int)(roi_x - 1)), x_end = min(wo, (int)(roi_x + roi_w + 2));
+						if (!whole) {
+							//cells touching the rect (texts of neighbors are clipped by the rect)
+							y_start = max(y_start, (int)floor(roi_y + clip.y * roi_h_div_win_h) - 1);
+							y_end = min(y_end, (int)(roi_y + (clip.y + clip.height) * roi_h_div_win_h) + 2);
+							x_start = max(x_start, (int)floor(roi_x + clip.x * roi_w_div_win_w) - 1);
+							x_end = min(x_end, (int)(roi_x + (clip.x + clip.width) * roi_w_div_win_w) + 2);
+						}
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+						for (int i = x_start; i <= x_end; ++i) {
+							auto x_pos = (int)round(x_to_win(i));
+							line(vis, Point(x_pos, top_to_win) - offset, Point(x_pos, bottom_to_win) - offset, m_grid_color, m_grid_thickness);
+						}
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+						for (int i = y_start; i <= y_end; ++i) {
+							auto y_pos = (int)round(y_to_win(i));
+							line(vis, Point(left_to_win, y_pos) - offset, Point(right_to_win, y_pos) - offset, m_grid_color, m_grid_thickness);
+						}
+						if (m_raw_mode) {
+							prepare_color_tiles(x_start, x_end, y_start, y_end);
+						}
+						s_grid_txts job;
+						job.x_start = x_start;
+						job.x_end = x_end;
+						job.y_next = y_start;
+						job.y_end = y_end;
+						if (whole) {
+							m_grid_txts = job;
+							render_grid_txts(m_grid_txts, deadline, vis, offset);
+						}
+						else {
+							render_grid_txts(job, chrono::steady_clock::time_point::max(), vis, offset);
+						}
+					}
+					else {
+						rectangle(vis, Rect(Point2i(left_to_win - 1, top_to_win - 1) - offset, Point2i(right_to_win + 1, bottom_to_win + 1) - offset), m_grid_color, m_grid_thickness);
+					}
+#undef x_to_win
+#undef y_to_win
+				}
+			}
+
+			/**
+			draw subtitles and box over the rendered view (again after each slice of texts, so they stay on top)
+			**/
+			inline void draw_decorations() {
+				register float roi_w, roi_h, roi_x, roi_y, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h;
+				cal_roi(m_center, m_scale_factor, roi_x, roi_y, roi_w, roi_h, roi_w_div_win_w, roi_h_div_win_h, win_w_div_roi_w, win_h_div_roi_h);
+				register int wo = m_org_size.width, ho = m_org_size.height;
+				if (m_colored_txts.size() > 0) {
+					//subtitles are rasterized once per frame / window size, views only composite them
+					if (m_txt_overlays_size != m_win_size) {
+						build_txt_overlays();
+					}
+					composite_txt_overlays(m_colored_vis);
+				}
+				//draw box
+				if (m_box_en) {
+					int  box_size_w = 0, box_size_h = 0;
+					if (m_org_size.width > m_org_size.height) {
+						box_size_w = m_box_size;
+						box_size_h = box_size_w * m_org_size.height / m_org_size.width;
 					}
 					else {
 						box_size_h = m_box_size;
@@ -496,41 +1410,187 @@ namespace emat {
 					}
 					auto box_rect = Rect(m_colored_vis.cols - box_size_w - m_box_margin, m_box_margin, box_size_w, box_size_h);
 					if (box_rect.x > 0 && box_rect.y > 0 && box_rect.x + box_rect.width <= m_win_size.width && box_rect.y + box_rect.height <= m_win_size.height) {
-						Mat img_box, img_box_roi;
-						resize(m_colored, img_box, box_rect.size());
-						img_box_roi = Mat::zeros(img_box.size(), img_box.type());
-						float img_box_w_scale_factor = (float)img_box.cols / m_colored.cols, img_box_h_scale_factor = (float)img_box.rows / m_colored.rows;
-						rectangle(img_box_roi,
-							Rect((int)round(roi_x * img_box_w_scale_factor), (int)round(roi_y * img_box_h_scale_factor), (int)ceil(roi_w * img_box_w_scale_factor), (int)ceil(roi_h * img_box_h_scale_factor)),
-							m_box_color, -1);
-						addWeighted(img_box, 0.5, img_box_roi, 0.5, 0.0, img_box);
-						img_box.copyTo(m_colored_vis(box_rect));
+						if (!m_box_thumb_valid || m_box_thumb.size() != box_rect.size()) {
+							//thumbnail is built once per frame, and kept pre-halved (the 50% blend with the highlight)
+							if (m_raw_mode) {
+								s_coord_map box_xs, box_ys;
+								box_xs.update(0.f, (float)wo / box_rect.width, box_rect.width, wo);
+								box_ys.update(0.f, (float)ho / box_rect.height, box_rect.height, ho);
+								m_box_thumb.create(box_rect.size(), CV_8UC3);
+								vis_colorize_sampled(m_raw, m_policy, box_xs.m_idx.data(), box_xs.m_start, box_xs.m_end, box_ys.m_idx.data(), box_ys.m_start, box_ys.m_end, m_box_thumb);
+							}
+							else {
+								resize(m_colored, m_box_thumb, box_rect.size());
+							}
+							m_box_thumb.convertTo(m_box_thumb, -1, 0.5);
+							m_box_thumb_valid = true;
+						}
+						Mat img_box = m_colored_vis(box_rect);
+						m_box_thumb.copyTo(img_box);
+						float img_box_w_scale_factor = (float)img_box.cols / wo, img_box_h_scale_factor = (float)img_box.rows / ho;
+						Rect box_roi = Rect((int)round(roi_x * img_box_w_scale_factor), (int)round(roi_y * img_box_h_scale_factor), (int)ceil(roi_w * img_box_w_scale_factor), (int)ceil(roi_h * img_box_h_scale_factor))
+							& Rect(0, 0, img_box.cols, img_box.rows);
+						if (box_roi.area() > 0) {
+							//highlight is composited over the roi rectangle only
+							Mat img_box_roi = img_box(box_roi);
+							add(img_box_roi, m_box_color * 0.5, img_box_roi);
+						}
 						cv::rectangle(m_colored_vis, box_rect, m_box_color, m_box_thickness);
 					}
 				}
+			}
+
+			/**
+			whether texts of cells are left by a budgeted render (dropped when the view changes)
+			**/
+			inline bool txts_pending() const {
+				return m_grid_txts.y_next < m_grid_txts.y_end && !m_dirty_roi && !m_colored_vis.empty();
+			}
+
+			/**
+			render texts of cells left by a budgeted render in an idle slice
+			@param budget_ms [in] budget of slice (ms), 0: all texts left
+			@return whether view changed
+			**/
+			inline bool continue_txts(const int& budget_ms) {
+				if (!txts_pending()) {
+					return false;
+				}
+				render_grid_txts(m_grid_txts, deadline_of(chrono::steady_clock::now(), budget_ms), m_colored_vis, Point(0, 0));
+				draw_decorations();
 				update_tiptool(m_tiptool_loc, true);
+				return true;
+			}
+
+			static inline size_t mat_bytes(const Mat& mat) {
+				return mat.empty() ? 0 : (mat.dims > 2 ? mat.total() * mat.elemSize() : mat.step[0] * mat.rows);
+			}
+
+			/**
+			memory used by frame and values (bytes)
+			**/
+			inline size_t mem_source() const {
+				size_t res = mat_bytes(m_colored);
+				if (m_slices.size() > 0 && !m_stack.empty()) {
+					res += mat_bytes(m_stack);
+				}
+				else if (m_slices.size() > 0) {
+					for (auto& slice : m_slices) {
+						res += mat_bytes(slice);
+					}
+				}
+				else {
+					res += m_native.empty() ? mat_bytes(m_raw) : mat_bytes(m_native);
+				}
+				return res;
+			}
+
+			/**
+			memory used by buffers derived from frame (bytes), see evict_derived
+			**/
+			inline size_t mem_derived() const {
+				size_t res = mat_bytes(m_colored_vis) + mat_bytes(m_colored_vis_tiptool) + mat_bytes(m_box_thumb) + mat_bytes(m_slice_base) + m_arena.capacity()
+					+ (m_maps->m_xos.m_idx.capacity() + m_maps->m_yos.m_idx.capacity()) * sizeof(int);
+				for (auto& tile : m_color_tiles) {
+					res += mat_bytes(tile);
+				}
+				for (auto& overlay : m_txt_overlays) {
+					res += mat_bytes(overlay.mask) + mat_bytes(overlay.color);
+				}
+				for (auto& tile : m_txt_tiles) {
+					res += tile ? m_txt_tile_size * m_txt_tile_size * sizeof(s_val_txts) : 0;
+				}
+				return res;
+			}
+
+			/**
+			release buffers derived from frame (visualization, text / color tiles, thumbnail, maps, arena),
+			they are rebuilt lazily by the next render
+			**/
+			inline void evict_derived() {
+				m_colored_vis.release();
+				m_colored_vis_tiptool.release();
+				m_box_thumb.release();
+				m_box_thumb_valid = false;
+				m_slice_base.release();
+				m_txt_overlays.clear();
+				m_txt_overlays_size = Size();
+				for (auto& tile : m_color_tiles) {
+					tile.release();
+				}
+				m_color_tiles_ready.assign(m_color_tiles.size(), 0);
+				reset_txts();
+				m_maps->m_xos = s_coord_map();
+				m_maps->m_yos = s_coord_map();
+				m_arena.shrink();
+				m_dirty_roi = true;
+			}
+
+			/**
+			change view without rendering (rendered by flush, so bursts of mouse events render once)
+			**/
+			inline void set_view(const Point2f& center, const float& scale_factor) {
+				m_center = center;
+				m_scale_factor = scale_factor;
+				m_dirty_roi = true;
+			}
+
+			/**
+			enable / disable box (rendered by flush)
+			**/
+			inline void set_box_enable(const bool& enable) {
+				m_box_en = enable;
+				m_dirty_roi = true;
+			}
+
+			/**
+			reset roi (rendered by flush)
+			**/
+			inline void reset_roi() {
+				float org_w = (float)m_org_size.width, org_h = (float)m_org_size.height;
+				set_view(Point2f(org_w / 2, org_h / 2), 1.f);
 			}
 
 			/**
-			reset roi
+			move tiptool (rendered by flush)
 			**/
-			inline void set_box_enable(const bool& enable) {
-				m_box_en = enable;
-				set_roi(m_center, m_scale_factor);
+			inline void set_tiptool(const Point2f& mouse) {
+				m_pending_tiptool_loc = mouse;
+				m_dirty_tiptool = true;
 			}
 
 			/**
-			reset roi
+			render pending view / tiptool changes
+			@param budget_ms [in] frame budget of view changes (see set_roi)
+			@return whether m_colored_vis_tiptool changed
 			**/
-			inline void reset_roi() {
-				float org_w = (float)m_org_size.width, org_h = (float)m_org_size.height;
-				set_roi(Point2f(org_w / 2, org_h / 2), 1.f);
+			inline bool flush(const int& budget_ms = 0) {
+				bool changed = m_dirty_roi || (m_dirty_tiptool && m_pending_tiptool_loc != m_tiptool_loc);
+				if (m_dirty_tiptool) {
+					m_dirty_tiptool = false;
+					if (m_dirty_roi) {
+						m_tiptool_loc = m_pending_tiptool_loc;
+					}
+					else {
+						update_tiptool(m_pending_tiptool_loc, false);
+					}
+				}
+				if (m_dirty_roi) {
+					set_roi(m_center, m_scale_factor, budget_ms);
+				}
+				return changed;
 			}
 
 			/**
 			update tiptool
 			**/
 			inline void update_tiptool(const Point2f& mouse, const bool& force) {
+				if (m_colored_vis.empty()) {
+					//buffers were evicted (see evict_derived): render again
+					m_tiptool_loc = mouse;
+					set_roi(m_center, m_scale_factor);
+					return;
+				}
 				if (force == false && mouse == m_tiptool_loc)
 					return;
 				m_tiptool_loc = mouse;
@@ -539,7 +1599,7 @@ namespace emat {
 					Point2f anchor_after;
 					loc_from_mouse(mouse, anchor_after);
 					if (anchor_after.x >= 0 && anchor_after.y >= 0 && anchor_after.x < m_raw.cols && anchor_after.y < m_raw.rows && m_grid_view_mode == false) {
-						vector<string>* txts;
+						s_val_txts* txts;
 						raw_val_to_txt((int)(anchor_after.x), (int)(anchor_after.y), txts);
 						Size txts_size;
 						get_txts_size(*txts, m_tiptool_font_face, m_tiptool_font_scale, m_tiptool_font_thickness, txts_size);
@@ -548,9 +1608,10 @@ namespace emat {
 							Rect rect_roi = Rect(font_loc.x, font_loc.y - txts_size.height, txts_size.width, txts_size.height);
 							Vec4i vec_roi_pad;
 							select_roi(m_colored_vis_tiptool, rect_roi, rect_roi, vec_roi_pad);
-							Mat img_roi = m_colored_vis_tiptool(rect_roi) / 2;
+							//darken and draw in place (no temporary)
+							Mat img_roi = m_colored_vis_tiptool(rect_roi);
+							img_roi.convertTo(img_roi, -1, 0.5);
 							put_txts(*txts, Point(0 - vec_roi_pad[2], txts_size.height - vec_roi_pad[0]), m_tiptool_font_face, m_tiptool_font_scale, m_tiptool_font_color, m_tiptool_font_thickness, img_roi);
-							img_roi.copyTo(m_colored_vis_tiptool(rect_roi));
 						}
 					}
 				}
@@ -569,6 +1630,200 @@ namespace emat {
 		mutex m_lock;
 		unordered_map<string, tuple<unique_ptr<s_cache_display>, viewer*>> m_cache_display;
 		u64 m_idx = 0;
+		int m_val_precision = 3;
+		int m_refresh_ms = 16;				//min interval of renders triggered by mouse events (events in between are coalesced)
+		int m_frame_budget_ms = -1;			//default budget of new windows (see set_frame_budget)
+		bool m_damage_tracking = true;		//default of new windows (see set_damage_tracking)
+		string m_tiptool_win;				//window which shows the tiptool
+		size_t m_mem_budget = 0;			//bytes of all windows, 0: unlimited (see set_mem_budget)
+
+		/*
+		watched source of a window (see watch)
+		*/
+		class s_watch_entry {
+		public:
+			s_watch watch;
+			bool raw_mode = true;			//false: CV_8UC3 snapshots are shown as is (others are colorized by policy)
+			s_vis_policy policy;
+			Size win_size;
+			vector<s_viewer_text> texts;
+			Mat snapshot;					//buffer of snapshots (shared with the display of window)
+			chrono::steady_clock::time_point last_poll;
+		};
+		unordered_map<string, s_watch_entry> m_watches;
+
+		/*
+		windows whose view (center / scale) is linked (see link_views)
+		*/
+		class s_view_group {
+		public:
+			vector<string> win_names;
+			shared_ptr<s_cache_display::s_view_maps> maps = make_shared<s_cache_display::s_view_maps>();
+		};
+		unordered_map<string, shared_ptr<s_view_group>> m_view_groups;		//name of window => its group
+
+		void unlink_view_(const string& win_name) {
+			auto it = m_view_groups.find(win_name);
+			if (it == m_view_groups.end()) return;
+			auto& names = it->second->win_names;
+			names.erase(remove(names.begin(), names.end(), win_name), names.end());
+			auto display = m_cache_display.find(win_name);
+			if (display != m_cache_display.end() && get<0>(display->second)->m_maps == it->second->maps) {
+				get<0>(display->second)->m_maps = make_shared<s_cache_display::s_view_maps>();
+			}
+			m_view_groups.erase(it);
+		}
+
+		/**
+		apply view of a window to its linked windows and render all of them,
+		windows of same size share the maps of the group (updated by the first render), the others are rendered in parallel
+		@param item [in] window which was interacted with
+		@param group [in] group of item
+		@return
+		**/
+		void render_group(s_cache_display& item, s_view_group& group) {
+			auto now = chrono::steady_clock::now();
+			vector<s_cache_display*> items(1, &item);
+			for (auto& win_name : group.win_names) {
+				auto it = m_cache_display.find(win_name);
+				if (win_name == item.m_win_name || it == m_cache_display.end()) continue;
+				auto member = get<0>(it->second).get();
+				if (member->m_center != item.m_center || member->m_scale_factor != item.m_scale_factor) {
+					member->set_view(item.m_center, item.m_scale_factor);
+				}
+				member->m_last_view = now;
+				items.emplace_back(member);
+			}
+			for (auto member : items) {
+				Size win_size = get_window_image_rect(member->m_win_name).size();
+				if (win_size.width > 0 && win_size.height > 0 && win_size != member->m_win_size) {
+					member->m_win_size = win_size;
+					member->m_dirty_roi = true;
+				}
+			}
+			//maps are only shared by windows of same size (an update of other sizes would rebuild them)
+			vector<s_cache_display*> shared_items, other_items;
+			for (auto member : items) {
+				if (member->m_win_size == item.m_win_size && member->m_org_size == item.m_org_size) {
+					member->m_maps = group.maps;
+					if (member != &item) shared_items.emplace_back(member);
+				}
+				else {
+					if (member->m_maps == group.maps) {
+						member->m_maps = make_shared<s_cache_display::s_view_maps>();
+					}
+					other_items.emplace_back(member);
+				}
+			}
+			vector<char> changed(items.size(), 0);
+			bool maps_ready = item.m_dirty_roi;
+			changed[0] = item.flush(frame_budget(item));
+			int shared_cnt = (int)shared_items.size(), first = 0;
+			while (!maps_ready && first < shared_cnt) {
+				//maps are written by the first render only, the others read them concurrently
+				maps_ready = shared_items[first]->m_dirty_roi;
+				changed[1 + first] = shared_items[first]->flush(frame_budget(*shared_items[first]));
+				++first;
+			}
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt) if (shared_cnt - first > 1)
+#endif
+			for (int i = first; i < shared_cnt; ++i) {
+				changed[1 + i] = shared_items[i]->flush(frame_budget(*shared_items[i]));
+			}
+			for (int i = 0; i < (int)other_items.size(); ++i) {
+				changed[1 + shared_cnt + i] = other_items[i]->flush(frame_budget(*other_items[i]));
+			}
+			shared_items.insert(shared_items.begin(), &item);
+			shared_items.insert(shared_items.end(), other_items.begin(), other_items.end());
+			for (int i = 0; i < (int)shared_items.size(); ++i) {
+				if (changed[i]) {
+					img_show(shared_items[i]->m_win_name, shared_items[i]->m_colored_vis_tiptool);
+				}
+				shared_items[i]->m_last_render = now;
+			}
+		}
+
+		/**
+		snapshot watched sources of windows which are visible (or not shown yet), at most once per refresh interval
+		@param show [in] show updated windows (imgs_show shows them itself)
+		@return
+		**/
+		void poll_watches(const bool& show) {
+			auto now = chrono::steady_clock::now();
+			for (auto& key : m_watches) {
+				auto& entry = key.second;
+				bool shown = m_img_show_histroy.find(key.first) != m_img_show_histroy.end();
+				if (shown && (now - entry.last_poll < chrono::milliseconds(m_refresh_ms) || !is_window_visible(key.first))) continue;
+				entry.last_poll = now;
+				if (!entry.watch.snapshot(entry.snapshot)) continue;
+				if (!entry.raw_mode && entry.snapshot.type() == CV_8UC3) {
+					get_cache_display(key.first, entry.win_size, entry.snapshot.size()).set_frame(entry.snapshot, entry.snapshot, m_idx, entry.texts, true);
+				}
+				else {
+					get_cache_display(key.first, entry.win_size, vis_format_size(entry.snapshot, entry.policy.m_format)).set_frame(entry.snapshot, entry.policy, m_idx, entry.texts, true);
+				}
+				if (show && shown) {
+					auto& item = get<0>(m_cache_display[key.first]);
+					item->m_last_render = now;
+					item->m_last_view = now;
+					img_show(item->m_win_name, item->m_colored_vis_tiptool);
+				}
+			}
+		}
+
+		/**
+		release derived buffers of least recently viewed windows until memory is within budget,
+		only hidden windows and windows not shown by the current / last imgs_show are evicted
+		(buffers of windows shown every frame are rebuilt by each frame anyway, releasing them would only add reallocations)
+		@param keep [in] window which is not evicted (e.g. the one being interacted with)
+		@return
+		**/
+		void enforce_mem_budget(const s_cache_display* keep) {
+			if (m_mem_budget == 0) return;
+			size_t total = 0;
+			vector<s_cache_display*> items;
+			for (auto& key : m_cache_display) {
+				auto item = get<0>(key.second).get();
+				total += item->mem_source() + item->mem_derived();
+				items.emplace_back(item);
+			}
+			if (total <= m_mem_budget) return;
+			sort(items.begin(), items.end(), [](const s_cache_display* a, const s_cache_display* b) { return a->m_last_view < b->m_last_view; });
+			for (auto item : items) {
+				if (item == keep) continue;
+				bool active = (i64)m_idx - item->m_shown_idx <= 1 && is_window_visible(item->m_win_name);
+				if (active) continue;
+				total -= item->mem_derived();
+				item->evict_derived();
+				if (total <= m_mem_budget) break;
+			}
+		}
+
+		/**
+		get display of window (created on first use, kept alive so buffers are reused by following frames), size of window is updated
+		**/
+		s_cache_display& get_cache_display(const string& win_name, const Size& win_size, const Size& org_size) {
+			auto it = m_cache_display.find(win_name);
+			if (it == m_cache_display.end()) {
+				it = m_cache_display.emplace(win_name, tuple<unique_ptr<s_cache_display>, viewer*>(
+					unique_ptr<s_cache_display>(new s_cache_display(win_name, win_size, m_val_precision)),
+					(viewer*)this)).first;
+				get<0>(it->second)->m_frame_budget_ms = m_frame_budget_ms;
+				get<0>(it->second)->m_damage_tracking = m_damage_tracking;
+			}
+			auto& cache_display = get<0>(it->second);
+			if (cache_display->m_org_size == org_size) {
+				Size win_size_cur = get_window_image_rect(win_name).size();
+				if (win_size_cur.width > 0 && win_size_cur.height > 0) {
+					cache_display->m_win_size = win_size_cur;
+				}
+			}
+			else {
+				cache_display->m_win_size = win_size;
+			}
+			return *cache_display;
+		}
 		std::set<string> m_img_show_histroy;
 	protected:
 		/* if you want to view windows in your own UI, just override these functions (Easy to combine with Qt, ...)*/
@@ -621,24 +1876,11 @@ namespace emat {
 		{
 			lock_guard<mutex> lock_(m_lock);
 			assert(img_colored.type() == CV_8UC3);
-			bool use_prev_setting = (m_cache_display.find(win_name) != m_cache_display.end()) &&
-				(get<0>(m_cache_display[win_name])->m_org_size == img_colored.size());
-			if (use_prev_setting) {
-				get<0>(m_cache_display[win_name])->set_win_size(get_window_image_rect(win_name).size());
-			}
-			m_cache_display[win_name] = tuple<unique_ptr<s_cache_display>, viewer*>(
-				unique_ptr<s_cache_display>(new s_cache_display(
-					win_name,
-					use_prev_setting ? get<0>(m_cache_display[win_name])->m_win_size : win_size,
-					img_colored,
-					img_raw.total() ? img_raw : Mat::zeros(img_colored.size(), CV_8U),
-					use_prev_setting ? get<0>(m_cache_display[win_name])->m_center : Point2f((float)img_colored.cols / 2, (float)img_colored.rows / 2),
-					use_prev_setting ? get<0>(m_cache_display[win_name])->m_scale_factor : 1.f,
-					m_idx,
-					texts,
-					use_prev_setting ? get<0>(m_cache_display[win_name])->m_tiptool_loc : Point2f(-1.f, -1.f),
-					use_prev_setting ? get<0>(m_cache_display[win_name])->m_box_en : false)),
-					(viewer*)this);
+			get_cache_display(win_name, win_size, img_colored.size()).set_frame(
+				img_colored,
+				img_raw.total() ? img_raw : Mat::zeros(img_colored.size(), CV_8U),
+				m_idx,
+				texts);
 			//get<0>(m_cache_display[win_name])->m_tag = (void*)&m_cache_display;
 		}
 
@@ -652,6 +1894,121 @@ namespace emat {
 			img_show_cache(win_name, Size((int)(img_colored.cols * scaled), (int)(img_colored.rows * scaled)), img_colored, img_raw, texts);
 		}
 
+		/**
+		cache img_show without copying: frames are referenced by the window until next frame of it is cached,
+		caller must not write into img_colored / img_raw afterwards (e.g. frames of s_capture, whose buffers are not reused while referenced)
+		@param win_name [in] name of window.
+		@param win_size [in] size of window.
+		@param img_colored [in] image to display (CV_8U3C).
+		@param img_raw [in] image with related values (same size with img_colored)
+		@param texts [in] texts will be rendered on screen.
+		@return
+		**/
+		void img_show_cache_shared(const string& win_name, const Size& win_size, const Mat& img_colored, const Mat& img_raw, const vector<s_viewer_text>& texts)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			assert(img_colored.type() == CV_8UC3);
+			get_cache_display(win_name, win_size, img_colored.size()).set_frame(
+				img_colored,
+				img_raw.total() ? img_raw : Mat::zeros(img_colored.size(), CV_8U),
+				m_idx,
+				texts,
+				true);
+		}
+
+		void img_show_cache_shared(const string& win_name, const Size& win_size, const Mat& img_raw, const s_vis_policy& policy, const vector<s_viewer_text>& texts)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			assert(img_raw.channels() == 1);
+			get_cache_display(win_name, win_size, vis_format_size(img_raw, policy.m_format)).set_frame(img_raw, policy, m_idx, texts, true);
+		}
+
+		/**
+		cache img_show of a stack / volume: slices along the leading dims are viewed without copy (navigated by ctrl + wheel or set_slice),
+		caller must not write into volume afterwards, the selected slice is kept while the same volume is given again
+		@param win_name [in] name of window.
+		@param win_size [in] size of window.
+		@param volume [in] N-D single channel mat (e.g. depth x rows x cols), the last two dims are the image
+		@param policy [in] color map / range (the range is updated per slice unless fixed)
+		@param texts [in] texts will be rendered on screen.
+		@return
+		**/
+		void img_show_cache_stack(const string& win_name, const Size& win_size, const Mat& volume, const s_vis_policy& policy, const vector<s_viewer_text>& texts)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			assert(volume.channels() == 1);
+			vector<Mat> slices;
+			nd_slices(volume, slices);
+			get_cache_display(win_name, win_size, slices.front().size()).set_stack(volume, slices, policy, m_idx, texts);
+		}
+
+		void img_show_cache_stack(const string& win_name, const Size& win_size, const vector<Mat>& slices, const s_vis_policy& policy, const vector<s_viewer_text>& texts)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			assert(slices.size() > 0 && slices.front().channels() == 1);
+			get_cache_display(win_name, win_size, slices.front().size()).set_stack(Mat(), slices, policy, m_idx, texts);
+		}
+
+		/**
+		select slice of a stack window (rendered by the next imgs_show / event)
+		**/
+		void set_slice(const string& win_name, const int& idx)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			auto iter = m_cache_display.find(win_name);
+			if (iter != m_cache_display.end()) {
+				get<0>(iter->second)->set_slice(idx);
+			}
+		}
+
+		/**
+		get selected slice of a stack window (-1 if no stack is shown)
+		**/
+		int get_slice(const string& win_name)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			auto iter = m_cache_display.find(win_name);
+			if (iter == m_cache_display.end() || get<0>(iter->second)->slices_cnt() == 0) return -1;
+			return get<0>(iter->second)->slice_idx();
+		}
+
+		/**
+		cache img_show of raw values only: pixels are colorized by policy on demand (only pixels sampled by the view, colorized tiles are cached when zoomed in)
+		@param win_name [in] name of window.
+		@param win_size [in] size of window.
+		@param img_raw [in] single channel image with values (any depth), or a NV12 / Bayer buffer of the camera (converted on demand, values are shown natively)
+		@param policy [in] color map / range (e.g. s_vis_policy(COLORMAP_JET, s_vis_range::percentile())), or format (s_vis_policy::nv12(), s_vis_policy::bayer(vis_format_bayer_rggb, 10))
+		@param texts [in] texts will be rendered on screen.
+		@return
+		**/
+		void img_show_cache(const string& win_name, const Size& win_size, const Mat& img_raw, const s_vis_policy& policy, const vector<s_viewer_text>& texts)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			assert(img_raw.channels() == 1);
+			get_cache_display(win_name, win_size, vis_format_size(img_raw, policy.m_format)).set_frame(img_raw, policy, m_idx, texts);
+		}
+
+		void img_show_cache(const string& win_name, const Mat& img_raw, const s_vis_policy& policy, const vector<s_viewer_text>& texts)
+		{
+			img_show_cache(win_name, vis_format_size(img_raw, policy.m_format), img_raw, policy, texts);
+		}
+
+		/**
+		set precision of values displayed in grid mode / tiptool
+		@param win_name [in] name of window (empty: default of new windows)
+		@param precision [in] decimals of floating point values, -1: shortest text which reads back to the same value
+		@return
+		**/
+		void set_val_precision(const string& win_name, const int& precision) {
+			lock_guard<mutex> lock_(m_lock);
+			if (win_name.empty()) {
+				m_val_precision = precision;
+			}
+			else if (m_cache_display.find(win_name) != m_cache_display.end()) {
+				get<0>(m_cache_display[win_name])->set_val_precision(precision);
+			}
+		}
+
 		/**
 		get visible wins
 		**/
@@ -682,6 +2039,270 @@ namespace emat {
 				get<0>(key.second)->update_tiptool(Point2f(-1.f, -1.f), false);
 				img_show(get<0>(key.second)->m_win_name, get<0>(key.second)->m_colored_vis_tiptool);
 			}
+			m_tiptool_win.clear();
+		}
+
+		/**
+		move tiptool into a window, only the window which showed the tiptool before is cleared
+		**/
+		void move_tiptool(s_cache_display& item, const Point2f& mouse) {
+			if (m_tiptool_win.size() > 0 && m_tiptool_win != item.m_win_name) {
+				auto it = m_cache_display.find(m_tiptool_win);
+				if (it != m_cache_display.end()) {
+					auto& prev = get<0>(it->second);
+					prev->update_tiptool(Point2f(-1.f, -1.f), false);
+					img_show(prev->m_win_name, prev->m_colored_vis_tiptool);
+				}
+			}
+			m_tiptool_win = item.m_win_name;
+			item.set_tiptool(mouse);
+		}
+
+		/**
+		get frame budget of renders triggered by mouse events of a window (ms), 0: unlimited
+		**/
+		int frame_budget(const s_cache_display& item) const {
+			return item.m_frame_budget_ms < 0 ? m_refresh_ms : item.m_frame_budget_ms;
+		}
+
+		/**
+		render pending changes of a window, events of a burst are rendered at most once per refresh interval (latest state wins),
+		an event after an idle period (e.g. a single wheel tick) is rendered at once
+		@param item [in] display of window
+		@param force [in] render even if the last render is within the refresh interval
+		@param event [in] called by a mouse event (false: flush of pending changes)
+		@return
+		**/
+		void render_pending(s_cache_display& item, const bool& force, const bool& event = true) {
+			auto now = chrono::steady_clock::now();
+			bool idle = false;
+			if (event) {
+				idle = now - item.m_last_event >= chrono::milliseconds(m_refresh_ms);
+				item.m_last_event = now;
+				item.m_last_view = now;
+			}
+			if (!force && !idle && now - item.m_last_render < chrono::milliseconds(m_refresh_ms)) {
+				//deferred: rendered by a following event, imgs_show or flush_events
+				return;
+			}
+			if (!item.m_dirty_roi && !item.m_dirty_tiptool) {
+				//slice of texts left by a budgeted render
+				if (item.continue_txts(frame_budget(item))) {
+					img_show(item.m_win_name, item.m_colored_vis_tiptool);
+					item.m_last_render = now;
+				}
+				return;
+			}
+			auto group = m_view_groups.find(item.m_win_name);
+			if (group != m_view_groups.end()) {
+				render_group(item, *group->second);
+				enforce_mem_budget(&item);
+				return;
+			}
+			//geometry is queried once per render instead of once per event
+			Size win_size = get_window_image_rect(item.m_win_name).size();
+			if (win_size.width > 0 && win_size.height > 0 && win_size != item.m_win_size) {
+				item.m_win_size = win_size;
+				item.m_dirty_roi = true;
+			}
+			bool view_changed = item.m_dirty_roi;
+			bool changed = item.flush(frame_budget(item));
+			if (!view_changed) {
+				//tiptool moved only: texts left are continued as well
+				changed = item.continue_txts(frame_budget(item)) || changed;
+			}
+			if (changed) {
+				img_show(item.m_win_name, item.m_colored_vis_tiptool);
+			}
+			item.m_last_render = now;
+			enforce_mem_budget(&item);
+		}
+
+		/**
+		render changes (zoom / pan / tiptool) still pending from coalesced mouse events, e.g. after waitKey when no new frame is cached,
+		watched sources of visible windows are snapshotted too
+		**/
+		void flush_events() {
+			lock_guard<mutex> lock_(m_lock);
+			poll_watches(true);
+			for (auto& key : m_cache_display) {
+				render_pending(*get<0>(key.second), true, false);
+			}
+		}
+
+		/**
+		set memory budget of all windows, derived buffers of least recently viewed windows are released when it is exceeded
+		(frames and values are kept, released buffers are rebuilt when the window is viewed again)
+		@param bytes [in] budget, 0: unlimited
+		@return
+		**/
+		void set_mem_budget(const size_t& bytes) {
+			lock_guard<mutex> lock_(m_lock);
+			m_mem_budget = bytes;
+			enforce_mem_budget(0);
+		}
+
+		/**
+		get memory used by all windows (bytes)
+		**/
+		size_t mem_usage() {
+			lock_guard<mutex> lock_(m_lock);
+			size_t res = 0;
+			for (auto& key : m_cache_display) {
+				res += get<0>(key.second)->mem_source() + get<0>(key.second)->mem_derived();
+			}
+			return res;
+		}
+
+		/**
+		get memory used by a window (bytes)
+		@param win_name [in] name of window
+		@param res_source [out] frame and values
+		@param res_derived [out] buffers which can be released under memory pressure
+		@return
+		**/
+		void mem_usage(const string& win_name, size_t& res_source, size_t& res_derived) {
+			lock_guard<mutex> lock_(m_lock);
+			auto it = m_cache_display.find(win_name);
+			res_source = it != m_cache_display.end() ? get<0>(it->second)->mem_source() : 0;
+			res_derived = it != m_cache_display.end() ? get<0>(it->second)->mem_derived() : 0;
+		}
+
+		/**
+		watch a source instead of caching frames (like a debugger watch): the producer registers it once,
+		the viewer snapshots it at its own cadence (imgs_show / flush_events, at most once per refresh interval) and only while the window is visible,
+		so nothing is done on the hot path of the producer while the window is hidden
+		@param win_name [in] name of window.
+		@param win_size [in] size of window.
+		@param watch [in] source and consistency, e.g. s_watch::ref(img, lock), s_watch::buffer(p, size, CV_16U), s_watch::callback(func)
+		@param policy [in] color map / range of single channel sources
+		@param texts [in] texts will be rendered on screen.
+		@return
+		**/
+		void watch(const string& win_name, const Size& win_size, const s_watch& watch, const s_vis_policy& policy, const vector<s_viewer_text>& texts)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			auto& entry = m_watches[win_name];
+			entry.watch = watch;
+			entry.raw_mode = true;
+			entry.policy = policy;
+			entry.win_size = win_size;
+			entry.texts = texts;
+			entry.last_poll = chrono::steady_clock::time_point();
+		}
+
+		/**
+		watch a source of CV_8UC3 images (shown as is)
+		**/
+		void watch(const string& win_name, const Size& win_size, const s_watch& watch, const vector<s_viewer_text>& texts)
+		{
+			this->watch(win_name, win_size, watch, s_vis_policy(), texts);
+			lock_guard<mutex> lock_(m_lock);
+			m_watches[win_name].raw_mode = false;
+		}
+
+		/**
+		stop watching (the window is closed by next imgs_show unless a frame of it is cached again)
+		**/
+		void unwatch(const string& win_name)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			m_watches.erase(win_name);
+		}
+
+		/**
+		link views of windows (e.g. outputs of pipeline stages of same size): zoom / pan of one of them is applied to all,
+		they are rendered together and windows of same size share one set of resampling maps
+		@param win_names [in] names of windows (windows may be created later), a window is removed from its previous group
+		@return
+		**/
+		void link_views(const vector<string>& win_names)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			auto group = make_shared<s_view_group>();
+			for (auto& win_name : win_names) {
+				unlink_view_(win_name);
+				group->win_names.emplace_back(win_name);
+				m_view_groups[win_name] = group;
+			}
+		}
+
+		/**
+		remove window from its group of linked views
+		**/
+		void unlink_view(const string& win_name)
+		{
+			lock_guard<mutex> lock_(m_lock);
+			unlink_view_(win_name);
+		}
+
+		/**
+		set frame budget of renders triggered by mouse events: the resampled image and grid lines are shown at once,
+		texts of grid cells left are rendered in following slices (next mouse events without a view change, flush_events), a view change drops them
+		@param win_name [in] name of window (empty: default of new windows)
+		@param budget_ms [in] budget (ms), -1: refresh interval (default), 0: unlimited (all texts of a view are rendered at once)
+		@return
+		**/
+		void set_frame_budget(const string& win_name, const int& budget_ms) {
+			lock_guard<mutex> lock_(m_lock);
+			if (win_name.empty()) {
+				m_frame_budget_ms = budget_ms;
+			}
+			else if (m_cache_display.find(win_name) != m_cache_display.end()) {
+				get<0>(m_cache_display[win_name])->m_frame_budget_ms = budget_ms;
+			}
+		}
+
+		/**
+		compare new frames with the current one in tiles of 32 x 32 pixels (memcmp until the first difference of a tile),
+		only window regions / texts of changed tiles are rendered again while view and subtitles are unchanged
+		@param win_name [in] name of window (empty: default of new windows)
+		@param enable [in] enable (default) / disable, e.g. for frames which always change completely
+		@return
+		**/
+		void set_damage_tracking(const string& win_name, const bool& enable) {
+			lock_guard<mutex> lock_(m_lock);
+			if (win_name.empty()) {
+				m_damage_tracking = enable;
+			}
+			else if (m_cache_display.find(win_name) != m_cache_display.end()) {
+				get<0>(m_cache_display[win_name])->m_damage_tracking = enable;
+			}
+		}
+
+		/**
+		get changed area of the last frame of a window / area of frame (1: not compared, e.g. first frame, other size, range of colors changed)
+		**/
+		float damage_fraction(const string& win_name) {
+			lock_guard<mutex> lock_(m_lock);
+			auto it = m_cache_display.find(win_name);
+			return it != m_cache_display.end() ? get<0>(it->second)->m_damage_fraction : 1.f;
+		}
+
+		/**
+		get view of a window (e.g. to drive it by scripts)
+		@param win_name [in] name of window
+		@param scale_factor [out] width of visible region / width of image (1: whole image)
+		@param grid_view [out] whether values are rendered in grid cells
+		@return whether the window is cached
+		**/
+		bool get_view(const string& win_name, float& scale_factor, bool& grid_view) {
+			lock_guard<mutex> lock_(m_lock);
+			auto it = m_cache_display.find(win_name);
+			if (it == m_cache_display.end()) return false;
+			scale_factor = get<0>(it->second)->m_scale_factor;
+			grid_view = get<0>(it->second)->m_grid_view_mode;
+			return true;
+		}
+
+		/**
+		set min interval of renders triggered by mouse events
+		@param refresh_ms [in] interval (ms), e.g. 16 for 60 Hz displays, 0: render every event
+		@return
+		**/
+		void set_refresh_interval(const int& refresh_ms) {
+			lock_guard<mutex> lock_(m_lock);
+			m_refresh_ms = max(refresh_ms, 0);
 		}
 
 		/**
@@ -691,14 +2312,24 @@ namespace emat {
 		**/
 		void imgs_show(bool reopen_win) {
 			lock_guard<mutex> lock_(m_lock);
+			poll_watches(false);
 			for (auto& key : m_cache_display) {
 				auto& item = get<0>(key.second);
-				if (item->m_idx == m_idx) {
+				bool watched = m_watches.find(key.first) != m_watches.end();
+				if (item->m_idx == m_idx || watched) {
 					if (reopen_win || !is_win_closed(item->m_win_name)) {
+						if (watched && item->m_idx != m_idx && is_window_visible(item->m_win_name)) {
+							//watched source unchanged / not polled: already on screen
+							continue;
+						}
 						if(!is_window_visible(item->m_win_name)) {
 							named_window(item->m_win_name);
 						}
 						resize_window(item->m_win_name, item->m_win_size.width, item->m_win_size.height);
+						item->flush();
+						item->m_last_render = chrono::steady_clock::now();
+						item->m_last_view = item->m_last_render;
+						item->m_shown_idx = (i64)m_idx;
 						img_show(item->m_win_name, item->m_colored_vis_tiptool);
 						m_img_show_histroy.emplace(item->m_win_name);
 						auto mouse_func = [](int event, int x, int y, int flags, void* param) {
@@ -708,6 +2339,7 @@ namespace emat {
 							auto item = get<0>(*p_param).get();
 							auto father = get<1>(*p_param);
 							bool show_tiptool = false;
+							//view changes are applied to the state only, rendering is coalesced (see render_pending)
 							if (event == EVENT_LBUTTONDOWN) {
 								mouse_down = true;
 								mouse_down_img_center = item->m_center;
@@ -722,7 +2354,12 @@ namespace emat {
 								item->reset_roi();
 								show_tiptool = true;
 							}
-							if (event == EVENT_MOUSEWHEEL && mouse_down == false) {
+							if (event == EVENT_MOUSEWHEEL && mouse_down == false && (flags & EVENT_FLAG_CTRLKEY) && item->slices_cnt() > 1) {
+								//ctrl + wheel: navigate slices of stack
+								item->set_slice(item->slice_idx() + (father->get_mouse_wheel_delta(flags) > 0 ? -1 : 1));
+								show_tiptool = true;
+							}
+							else if (event == EVENT_MOUSEWHEEL && mouse_down == false) {
 								int curr_vis_blocks = (int)(item->m_org_size.width * item->m_scale_factor);
 								int thresholds[] = { 100, 34, 12, 2 };
 								for (auto threshold : thresholds) {
@@ -732,7 +2369,7 @@ namespace emat {
 										Point2f anchor_before, anchor_after;
 										item->loc_from_mouse(mouse, anchor_before);
 										item->loc_from_mouse(item->m_center, new_scale_factor, mouse, anchor_after);
-										item->set_roi(item->m_center - (anchor_after - anchor_before), new_scale_factor);
+										item->set_view(item->m_center - (anchor_after - anchor_before), new_scale_factor);
 										show_tiptool = true;
 										break;
 									}
@@ -741,7 +2378,7 @@ namespace emat {
 							if (event == EVENT_MOUSEMOVE && mouse_down == true) {
 								Point2f mouse((float)x, (float)y), mouse_move_img_loc;
 								item->loc_from_mouse(mouse_down_img_center, item->m_scale_factor, mouse, mouse_move_img_loc);
-								item->set_roi(mouse_down_img_center - (mouse_move_img_loc - mouse_down_img_loc), item->m_scale_factor);
+								item->set_view(mouse_down_img_center - (mouse_move_img_loc - mouse_down_img_loc), item->m_scale_factor);
 								show_tiptool = true;
 							}
 							if (event == EVENT_MOUSEMOVE) {
@@ -751,11 +2388,9 @@ namespace emat {
 								item->set_box_enable(!item->m_box_en);
 							}
 							if (show_tiptool) {
-								father->remove_tiptool();
-								item->set_win_size(father->get_window_image_rect(item->m_win_name).size());
-								item->update_tiptool(Point2f((float)x, (float)y), false);
-								father->img_show(item->m_win_name, item->m_colored_vis_tiptool);
+								father->move_tiptool(*item, Point2f((float)x, (float)y));
 							}
+							father->render_pending(*item, event != EVENT_MOUSEMOVE && event != EVENT_MOUSEWHEEL);
 						};
 						set_mouse_callback(item->m_win_name, mouse_func, (void*)&key.second);
 					}
@@ -768,6 +2403,7 @@ namespace emat {
 					m_cache_display.erase(key.first);
 				}
 			}
+			enforce_mem_budget(0);
 			++m_idx;
 		}
 
@@ -781,6 +2417,8 @@ namespace emat {
 			}
 			m_cache_display.clear();
 			m_img_show_histroy.clear();
+			m_watches.clear();
+			m_view_groups.clear();
 		}
 
 		/**
@@ -792,7 +2430,9 @@ namespace emat {
 				destroy_window(win_name);
 			}
 			m_img_show_histroy.erase(win_name);
+			unlink_view_(win_name);
 			m_cache_display.erase(win_name);
+			m_watches.erase(win_name);
 		}
 	};
 };
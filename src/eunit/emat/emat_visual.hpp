@@ -22,44 +22,276 @@
 #include "../../eunit/emat/emat_omp.hpp"
 #include <unordered_map>
 #include <mutex>
+#include <limits>
+#include <type_traits>
 
 using namespace emat;
 using namespace std;
 using namespace cv;
 
 namespace emat {
+	/*
+	persistent grid concat (mosaic): layout (cell size, rois, scale factors) and output buffer are cached,
+	only tiles flagged as changed by the caller are re-rendered
+	*/
+	class s_mosaic {
+	private:
+		class s_tile {
+		public:
+			Size size;
+			Rect roi;					//destination of the tile in mosaic
+			double fxy = 1.;			//scale factor (mosaic / source)
+			bool dirty = true;
+		};
+		vector<s_tile> m_tiles;
+		vector<Mat> m_srcs;
+		u32 m_cols = 0;
+		int m_type = -1;
+		Size m_cell_size;
+		Mat m_res;
+
+		/*
+		recalculate layout, return whether cell size or grid changed
+		*/
+		inline bool layout(const vector<Size>& sizes, const u32& cols, const int& type) {
+			Size cell_size;
+			for (auto& size : sizes) {
+				cell_size.width = max(cell_size.width, size.width);
+				cell_size.height = max(cell_size.height, size.height);
+			}
+			bool relayout = cell_size != m_cell_size || cols != m_cols || sizes.size() != m_tiles.size() || type != m_type;
+			if (relayout) {
+				m_cell_size = cell_size;
+				m_cols = cols;
+				m_type = type;
+				m_tiles.assign(sizes.size(), s_tile());
+				m_res = Mat::zeros(Size(m_cell_size.width * min(m_cols, (u32)sizes.size()), m_cell_size.height * (int)ceil((float)sizes.size() / m_cols)), m_type);
+			}
+			for (int i = 0, len = (int)sizes.size(); i < len; ++i) {
+				auto& tile = m_tiles[i];
+				if (relayout || tile.size != sizes[i]) {
+					tile.fxy = min((double)m_cell_size.width / (double)sizes[i].width, (double)m_cell_size.height / (double)sizes[i].height);
+					Size size_resized = (tile.fxy == 1) ? sizes[i] : Size(cvRound(sizes[i].width * tile.fxy), cvRound(sizes[i].height * tile.fxy));
+					Rect roi = Rect((i % m_cols) * m_cell_size.width + (m_cell_size.width - size_resized.width) / 2, (int)(i / m_cols) * m_cell_size.height + (m_cell_size.height - size_resized.height) / 2, size_resized.width, size_resized.height);
+					if (!relayout && roi != tile.roi) {
+						//clear the whole cell, the new tile may not cover the old one
+						m_res(Rect((i % m_cols) * m_cell_size.width, (int)(i / m_cols) * m_cell_size.height, m_cell_size.width, m_cell_size.height)).setTo(0);
+					}
+					tile.roi = roi;
+					tile.size = sizes[i];
+					tile.dirty = true;
+				}
+			}
+			return relayout;
+		}
+
+	public:
+		/**
+		update mosaic, all tiles are rendered again (a freed temporary may be reallocated at the same address,
+		and producers may write in place, so identity of buffers tells nothing about their content)
+		@param imgs [in] array with Mat type (must be same cv_type, but can be different size)
+		@param cols [in] the max count of images can be put in each colume
+		@return mosaic
+		**/
+		inline const Mat& update(const vector<Mat>& imgs, const u32& cols) {
+			return update(imgs, cols, vector<bool>(imgs.size(), true));
+		}
+
+		/**
+		update mosaic with explicit change flags, only changed tiles (and tiles whose layout changed) are rendered again
+		@param imgs [in] array with Mat type (must be same cv_type, but can be different size)
+		@param cols [in] the max count of images can be put in each colume
+		@param changed [in] whether imgs[i] changed since last update
+		@return mosaic
+		**/
+		inline const Mat& update(const vector<Mat>& imgs, const u32& cols, const vector<bool>& changed) {
+			if (imgs.size() == 0) {
+				m_tiles.clear();
+				m_res.release();
+				m_cell_size = Size();
+				return m_res;
+			}
+#if  emat_security_protection_en
+			assert(changed.size() == imgs.size());
+			for (int i = 0, len = (int)imgs.size() - 1; i < len; ++i) {
+				assert(imgs[i].type() == imgs[i + 1].type());
+			}
+#endif
+			vector<Size> sizes(imgs.size());
+			for (int i = 0, len = (int)imgs.size(); i < len; ++i) {
+				sizes[i] = imgs[i].size();
+			}
+			layout(sizes, cols, imgs[0].type());
+			m_srcs.resize(imgs.size());
+			for (int i = 0, len = (int)imgs.size(); i < len; ++i) {
+				auto& tile = m_tiles[i];
+				tile.dirty = tile.dirty || changed[i];
+				if (tile.dirty) {
+					m_srcs[i] = imgs[i];
+				}
+			}
+			return render();
+		}
+
+		/**
+		replace a single tile, it will be rendered on next "render" (call "update" if size of tile changed)
+		@param idx [in] index of tile
+		@param img [in] new image of tile (same cv_type and size as the previous one)
+		@return
+		**/
+		inline void set_tile(const int& idx, const Mat& img) {
+			assert(idx >= 0 && idx < (int)m_tiles.size() && img.type() == m_type && img.size() == m_tiles[idx].size);
+			auto& tile = m_tiles[idx];
+			tile.dirty = true;
+			m_srcs.resize(m_tiles.size());
+			m_srcs[idx] = img;
+		}
+
+		/**
+		render all dirty tiles (resized directly into their rois in parallel)
+		@return mosaic
+		**/
+		inline const Mat& render() {
+			register i32 tiles_len = (i32)m_tiles.size();
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt) schedule(dynamic)
+#endif
+			for (i32 i = 0; i < tiles_len; ++i) {
+				auto& tile = m_tiles[i];
+				if (!tile.dirty || m_srcs[i].empty()) continue;
+				Mat dst = m_res(tile.roi);
+				if (tile.fxy == 1) {
+					m_srcs[i].copyTo(dst);
+				}
+				else {
+					resize(m_srcs[i], dst, dst.size(), 0, 0, INTER_NEAREST);
+				}
+				tile.dirty = false;
+			}
+			for (auto& src : m_srcs) {
+				src.release();
+			}
+			return m_res;
+		}
+
+		/**
+		layout mosaic for tiles which are rendered by the caller into tile_mat (e.g. s_vis_batch), no tile is rendered by the mosaic
+		@param sizes [in] size of each tile
+		@param cols [in] the max count of images can be put in each colume
+		@param type [in] cv type of mosaic
+		@return mosaic
+		**/
+		inline const Mat& reserve(const vector<Size>& sizes, const u32& cols, const int& type) {
+			if (sizes.size() == 0) {
+				return update(vector<Mat>(), cols);
+			}
+			layout(sizes, cols, type);
+			for (auto& tile : m_tiles) {
+				tile.dirty = false;
+			}
+			return m_res;
+		}
+
+		/**
+		get destination of a tile in mosaic (view of mosaic)
+		**/
+		inline Mat tile_mat(const int& idx) {
+			return m_res(m_tiles[idx].roi);
+		}
+
+		/**
+		get mosaic
+		**/
+		inline const Mat& mat() const {
+			return m_res;
+		}
+
+		/**
+		get size of each cell
+		**/
+		inline const Size& cell_size() const {
+			return m_cell_size;
+		}
+
+		/**
+		get count of tiles
+		**/
+		inline int tiles_cnt() const {
+			return (int)m_tiles.size();
+		}
+
+		/**
+		get roi of a tile in mosaic
+		**/
+		inline const Rect& tile_roi(const int& idx) const {
+			return m_tiles[idx].roi;
+		}
+
+		/**
+		get scale factor (mosaic / source) of a tile
+		**/
+		inline double tile_scale(const int& idx) const {
+			return m_tiles[idx].fxy;
+		}
+
+		/**
+		map location in mosaic to location in source image
+		@param loc [in] location in mosaic
+		@param idx [out] index of tile (-1 if loc is not covered by any tile)
+		@param src_loc [out] location in source image
+		@return whether loc is covered by a tile
+		**/
+		template<typename T_Res>
+		inline bool loc_to_src(const Point2f& loc, int& idx, Point_<T_Res>& src_loc) const {
+			idx = -1;
+			if (m_tiles.size() == 0 || loc.x < 0 || loc.y < 0) return false;
+			int cell_idx = (int)(loc.y / m_cell_size.height) * (int)m_cols + (int)(loc.x / m_cell_size.width);
+			if ((int)(loc.x / m_cell_size.width) >= (int)m_cols || cell_idx >= (int)m_tiles.size()) return false;
+			auto& tile = m_tiles[cell_idx];
+			float x = (loc.x - tile.roi.x) / (float)tile.fxy, y = (loc.y - tile.roi.y) / (float)tile.fxy;
+			if (x < 0 || y < 0 || x >= tile.size.width || y >= tile.size.height) return false;
+			idx = cell_idx;
+			src_loc = Point_<T_Res>((T_Res)x, (T_Res)y);
+			return true;
+		}
+
+		/**
+		map location in source image to location in mosaic
+		@param idx [in] index of tile
+		@param src_loc [in] location in source image
+		@param loc [out] location in mosaic
+		@return
+		**/
+		template<typename T_Res>
+		inline void loc_from_src(const int& idx, const Point2f& src_loc, Point_<T_Res>& loc) const {
+			auto& tile = m_tiles[idx];
+			loc = Point_<T_Res>((T_Res)(tile.roi.x + src_loc.x * tile.fxy), (T_Res)(tile.roi.y + src_loc.y * tile.fxy));
+		}
+	};
+
 	/**
-	apply grid concat
+	apply grid concat (non-persistent compatibility wrapper: the mosaic is allocated and every tile is rendered on each call,
+	pass a s_mosaic of the caller to update it incrementally)
 	@param imgs [in] array with Mat type
 	@param res [out] variable with Mat type
 	@return
 	**/
 	inline void vis_gconcat(const vector<Mat>& imgs, const uint32_t& cols, Mat& res) {
 		if (imgs.size() == 0) return;
-#if  emat_security_protection_en
-		for (int i = 0, len = (int)imgs.size() - 1; i < len; ++i) {
-			assert(imgs[i].type() == imgs[i + 1].type());
-		}
-#endif
-		Size size_mat;
-		for (auto& img : imgs) {
-			size_mat.width = max(size_mat.width, img.cols);
-			size_mat.height = max(size_mat.height, img.rows);
-		}
-		res = Mat::zeros(Size(size_mat.width * min(cols, (uint32_t)imgs.size()), size_mat.height * (int)ceil((float)imgs.size() / cols)), imgs[0].type());
-		for (int i = 0, len = (int)imgs.size(); i < len; ++i) {
-			auto fxy = min((double)size_mat.width / (double)imgs[i].cols, (double)size_mat.height / (double)imgs[i].rows);
-			Mat img_resized;
-			if (fxy == 1) {
-				img_resized = imgs[i];
-			}
-			else {
-				resize(imgs[i], img_resized, Size(), fxy, fxy, INTER_NEAREST);
-			}
-			//rectangle(img_resized, Rect(0, 0, img_resized.cols, img_resized.rows), Scalar::all(255), 1);
-			Rect roi = Rect((i % cols) * size_mat.width + (size_mat.width - img_resized.cols) / 2, (int)(i / cols) * size_mat.height + (size_mat.height - img_resized.rows) / 2, img_resized.cols, img_resized.rows);
-			img_resized.copyTo(res(roi));
-		}
+		s_mosaic mosaic;
+		res = mosaic.update(imgs, cols);
+	}
+
+	/**
+	apply grid concat into a mosaic kept by the caller (layout and buffer are reused, only changed tiles are rendered again)
+	@param imgs [in] array with Mat type
+	@param cols [in] the max count of images can be put in each colume
+	@param mosaic [in,out] mosaic of caller
+	@param changed [in] whether imgs[i] changed since last call (empty: all of them)
+	@return mosaic
+	**/
+	inline const Mat& vis_gconcat(const vector<Mat>& imgs, const uint32_t& cols, s_mosaic& mosaic, const vector<bool>& changed = vector<bool>()) {
+		return changed.size() == 0 ? mosaic.update(imgs, cols) : mosaic.update(imgs, cols, changed);
 	}
 
 	/**
@@ -114,29 +346,879 @@ namespace emat {
 		return vis_gconcat(imgs, (uint32_t)imgs.size());
 	}
 
+	/*
+	range of raw values mapped onto the 256 entries of a color map
+	*/
+	class s_vis_range {
+	public:
+		enum e_mode {
+			range_fixed,		//[m_min, m_max] given by user
+			range_minmax,		//min / max of current frame (two passes: min / max + color map)
+			range_running,		//running average of min / max of previous frames (single pass, avoids flicker)
+			range_percentile,	//[m_low, m_high] percentiles estimated from a strided sample, smoothed across frames
+		};
+		e_mode m_mode;
+		double m_min;
+		double m_max;
+		float m_alpha;			//weight of the newest frame in range_running / range_percentile mode
+		bool m_valid;
+		float m_low = 0.01f;	//low percentile [0, 1] (range_percentile)
+		float m_high = 0.99f;	//high percentile [0, 1] (range_percentile)
+		u32 m_samples = 16384;	//count of sampled pixels (range_percentile)
+		vector<double> m_sample_buf;
+
+		s_vis_range(const e_mode& mode = range_minmax, const double& v_min = 0., const double& v_max = 255., const float& alpha = 0.1f)
+			: m_mode(mode), m_min(v_min), m_max(v_max), m_alpha(alpha), m_valid(mode == range_fixed) {
+		}
+
+		/**
+		create range with percentile auto-contrast
+		@param low [in] low percentile [0, 1]
+		@param high [in] high percentile [0, 1]
+		@param alpha [in] weight of the newest frame (1: no smoothing)
+		@param samples [in] count of sampled pixels
+		@return
+		**/
+		static inline s_vis_range percentile(const float& low = 0.01f, const float& high = 0.99f, const float& alpha = 0.2f, const u32& samples = 16384) {
+			s_vis_range range(range_percentile, 0., 255., alpha);
+			range.m_low = low;
+			range.m_high = high;
+			range.m_samples = samples;
+			return range;
+		}
+
+		/**
+		update range with min / max (finite values only) of a frame
+		**/
+		inline void update(const double& frame_min, const double& frame_max) {
+			if (m_mode == range_fixed || frame_min > frame_max) return;
+			if ((m_mode == range_running || m_mode == range_percentile) && m_valid) {
+				m_min += m_alpha * (frame_min - m_min);
+				m_max += m_alpha * (frame_max - m_max);
+			}
+			else {
+				m_min = frame_min;
+				m_max = frame_max;
+			}
+			m_valid = true;
+		}
+	};
+
+	enum {
+		vis_colormap_gray = -1,		//gray color map (not provided by cv::ColormapTypes)
+	};
+
+	/**
+	get BGR table (256 entries) of a color map, tables are built once and shared by all threads
+	@param colormap [in] cv::ColormapTypes or vis_colormap_gray
+	@return
+	**/
+	inline const Vec3b* vis_colormap_lut(const int& colormap) {
+		static mutex s_lock;
+		static unordered_map<int, Mat> s_luts;
+		lock_guard<mutex> lock_(s_lock);
+		auto& lut = s_luts[colormap];
+		if (lut.empty()) {
+			Mat idxs(1, 256, CV_8U);
+			for (int i = 0; i < 256; ++i) {
+				idxs.data[i] = (u8)i;
+			}
+			if (colormap == vis_colormap_gray) {
+				cvtColor(idxs, lut, COLOR_GRAY2BGR);
+			}
+			else {
+				applyColorMap(idxs, lut, colormap);
+			}
+		}
+		return lut.ptr<Vec3b>();
+	}
+
+	/*
+	whether a value is finite (always true for integers)
+	*/
+	template<typename T_Src>
+	inline bool vis_is_finite(const T_Src& v) {
+		return !std::is_floating_point<T_Src>::value || (v == v && v != numeric_limits<T_Src>::infinity() && v != -numeric_limits<T_Src>::infinity());
+	}
+
+	/**
+	min / max of finite values of a single channel mat
+	**/
+	template<typename T_Src>
+	inline void vis_minmax(const Mat& img, double& res_min, double& res_max) {
+		double mins[emat_omp_cnt], maxs[emat_omp_cnt];
+		register i32 rows = img.rows, cols = img.cols;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+		emat_omp{
+			T_Src v_min = numeric_limits<T_Src>::max(), v_max = numeric_limits<T_Src>::lowest();
+			for (i32 y = emat_omp_offset_range(0, rows), y_end = emat_omp_offset_next_range(0, rows); y < y_end; ++y) {
+				register auto p_src = img.ptr<T_Src>(y);
+				for (i32 x = 0; x < cols; ++x) {
+					register T_Src v = p_src[x];
+					if (vis_is_finite(v)) {
+						v_min = min(v_min, v);
+						v_max = max(v_max, v);
+					}
+				}
+			}
+			mins[emat_omp_idx] = (double)v_min;
+			maxs[emat_omp_idx] = (double)v_max;
+		}
+		res_min = numeric_limits<double>::max();
+		res_max = numeric_limits<double>::lowest();
+		for (int i = 0; i < emat_omp_cnt; ++i) {
+			if (mins[i] <= maxs[i]) {
+				res_min = min(res_min, mins[i]);
+				res_max = max(res_max, maxs[i]);
+			}
+		}
+	}
+
+	/**
+	estimate low / high percentiles of finite values from a strided sample (cost depends on sample count, not on size of mat)
+	@param img [in] single channel mat
+	@param low [in] low percentile [0, 1]
+	@param high [in] high percentile [0, 1]
+	@param samples [in] count of sampled pixels
+	@param buf [in] reusable sample buffer
+	@param res_low [out] value of low percentile
+	@param res_high [out] value of high percentile
+	@return
+	**/
+	template<typename T_Src>
+	inline void vis_percentile(const Mat& img, const float& low, const float& high, const u32& samples, vector<double>& buf, double& res_low, double& res_high) {
+		register i32 rows = img.rows, cols = img.cols;
+		if (rows == 0 || cols == 0) {
+			res_low = numeric_limits<double>::max();
+			res_high = numeric_limits<double>::lowest();
+			return;
+		}
+		//square grid of samples, an axis shorter than the stride (e.g. a 1 x N signal) is sampled densely along the other one
+		double stride = max(1., sqrt((double)img.total() / max(samples, 1u)));
+		register i32 stride_y = (i32)min(stride, (double)rows), stride_x = (i32)min(stride, (double)cols);
+		if (stride_y == rows) {
+			stride_x = max(1, (i32)((double)cols / max(samples, 1u)));
+		}
+		else if (stride_x == cols) {
+			stride_y = max(1, (i32)((double)rows / max(samples, 1u)));
+		}
+		buf.clear();
+		for (i32 y = min(stride_y / 2, rows - 1); y < rows; y += stride_y) {
+			register auto p_src = img.ptr<T_Src>(y);
+			//shift samples of each row to avoid aliasing with periodic patterns
+			for (i32 x = min((y / stride_y * 7) % stride_x, cols - 1); x < cols; x += stride_x) {
+				if (vis_is_finite(p_src[x])) {
+					buf.emplace_back((double)p_src[x]);
+				}
+			}
+		}
+		if (buf.size() == 0) {
+			res_low = numeric_limits<double>::max();
+			res_high = numeric_limits<double>::lowest();
+			return;
+		}
+		auto idx_low = (size_t)(min(max(low, 0.f), 1.f) * (buf.size() - 1)), idx_high = (size_t)(min(max(high, 0.f), 1.f) * (buf.size() - 1));
+		nth_element(buf.begin(), buf.begin() + idx_high, buf.end());
+		res_high = buf[idx_high];
+		nth_element(buf.begin(), buf.begin() + idx_low, buf.begin() + idx_high + 1);
+		res_low = buf[idx_low];
+	}
+
+	/*
+	range pre-pass kernel (see depth_dispatch)
+	*/
+	template<typename T_Src>
+	struct s_vis_range_kernel {
+		static inline void run(const Mat& img, s_vis_range& range, double& frame_min, double& frame_max) {
+			if (range.m_mode == s_vis_range::range_percentile) {
+				vis_percentile<T_Src>(img, range.m_low, range.m_high, range.m_samples, range.m_sample_buf, frame_min, frame_max);
+			}
+			else {
+				vis_minmax<T_Src>(img, frame_min, frame_max);
+			}
+		}
+	};
+
+	/**
+	update range before colorization (min / max or percentile pre-pass), shared by all colorization kernels
+	@param img [in] single channel mat (any depth)
+	@param range [in, out] range mode / state
+	@return whether the colorization pass should track min / max of the frame (range_running)
+	**/
+	inline bool vis_range_update(const Mat& img, s_vis_range& range) {
+		double frame_min = 0., frame_max = 0.;
+		if (range.m_mode == s_vis_range::range_fixed || (range.m_mode == s_vis_range::range_running && range.m_valid)) {
+			return range.m_mode == s_vis_range::range_running;
+		}
+		depth_dispatch<s_vis_range_kernel>::get(img.depth())(img, range, frame_min, frame_max);
+		range.update(frame_min, frame_max);
+		return false;
+	}
+
+	/*
+	color table with NaN entry and normalization factors of vis_colorize_* (shared by mat and generator sources)
+	*/
+	template<typename T_Src>
+	class s_vis_colorize_table {
+	public:
+		typedef typename conditional<(sizeof(T_Src) > 2), double, float>::type T_Acc;
+		Vec3b m_table[257];
+		T_Acc m_lo;
+		T_Acc m_scale;
+
+		s_vis_colorize_table(const Vec3b* lut, const Vec3b& nan_color, const double& v_min, const double& v_max) {
+			memcpy(m_table, lut, 256 * sizeof(Vec3b));
+			m_table[256] = nan_color;
+			m_lo = (T_Acc)v_min;
+			m_scale = (v_max > v_min) ? (T_Acc)(255. / (v_max - v_min)) : (T_Acc)0;
+		}
+
+		/**
+		colorize a row
+		@param p_src [in] values
+		@param cols [in] count of values
+		@param idxs [in] buffer of indices (cols)
+		@param p_res [out] colors
+		@param t_min [in, out] min of finite values (only if T_Track)
+		@param t_max [in, out] max of finite values (only if T_Track)
+		@return
+		**/
+		template<bool T_Track>
+		inline void row(const T_Src* p_src, const i32& cols, i32* idxs, Vec3b* p_res, T_Src& t_min, T_Src& t_max) const {
+			for (i32 x = 0; x < cols; ++x) {
+				register T_Acc v = (T_Acc)(p_src[x] - m_lo) * m_scale;
+				idxs[x] = (p_src[x] == p_src[x]) ? (i32)(v > 0 ? (v < 255 ? v : 255) : 0) : 256;
+			}
+			if (T_Track) {
+				for (i32 x = 0; x < cols; ++x) {
+					if (vis_is_finite(p_src[x])) {
+						t_min = min(t_min, p_src[x]);
+						t_max = max(t_max, p_src[x]);
+					}
+				}
+			}
+			for (i32 x = 0; x < cols; ++x) {
+				p_res[x] = m_table[idxs[x]];
+			}
+		}
+	};
+
+	/**
+	map raw values to BGR through a color map in a single pass (normalize + color map fused)
+	@param img [in] single channel mat
+	@param lut [in] 256 entries of color map
+	@param nan_color [in] color of NaN (+Inf / -Inf are mapped to last / first entry)
+	@param v_min [in] value mapped to lut[0]
+	@param v_max [in] value mapped to lut[255]
+	@param res [out] CV_8UC3 (allocated by caller)
+	@param res_min [out] min of finite values (only if T_Track)
+	@param res_max [out] max of finite values (only if T_Track)
+	@return
+	**/
+	template<typename T_Src, bool T_Track>
+	inline void vis_colorize_(const Mat& img, const Vec3b* lut, const Vec3b& nan_color, const double& v_min, const double& v_max, Mat& res, double& res_min, double& res_max) {
+		const s_vis_colorize_table<T_Src> table(lut, nan_color, v_min, v_max);
+		double mins[emat_omp_cnt], maxs[emat_omp_cnt];
+		register i32 rows = img.rows, cols = img.cols;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+		emat_omp{
+			T_Src t_min = numeric_limits<T_Src>::max(), t_max = numeric_limits<T_Src>::lowest();
+			vector<i32> idxs(cols);
+			for (i32 y = emat_omp_offset_range(0, rows), y_end = emat_omp_offset_next_range(0, rows); y < y_end; ++y) {
+				table.template row<T_Track>(img.ptr<T_Src>(y), cols, idxs.data(), res.ptr<Vec3b>(y), t_min, t_max);
+			}
+			mins[emat_omp_idx] = (double)t_min;
+			maxs[emat_omp_idx] = (double)t_max;
+		}
+		if (T_Track) {
+			res_min = numeric_limits<double>::max();
+			res_max = numeric_limits<double>::lowest();
+			for (int i = 0; i < emat_omp_cnt; ++i) {
+				if (mins[i] <= maxs[i]) {
+					res_min = min(res_min, mins[i]);
+					res_max = max(res_max, maxs[i]);
+				}
+			}
+		}
+	}
+
+	/*
+	colorization kernel (see depth_dispatch)
+	*/
+	template<typename T_Src>
+	struct s_vis_colorize_kernel {
+		static inline void run(const Mat& img, const Vec3b* lut, const Vec3b& nan_color, const bool& track, const double& v_min, const double& v_max, Mat& res, double& res_min, double& res_max) {
+			if (track) {
+				vis_colorize_<T_Src, true>(img, lut, nan_color, v_min, v_max, res, res_min, res_max);
+			}
+			else {
+				vis_colorize_<T_Src, false>(img, lut, nan_color, v_min, v_max, res, res_min, res_max);
+			}
+		}
+	};
+
+	/*
+	serial colorization kernel with index row of caller (see depth_dispatch), e.g. work items of s_vis_batch which already run in parallel
+	*/
+	template<typename T_Src>
+	struct s_vis_colorize_rows_kernel {
+		static inline void run(const Mat& img, const Vec3b* lut, const Vec3b& nan_color, const double& v_min, const double& v_max, i32* idxs, Mat& res) {
+			const s_vis_colorize_table<T_Src> table(lut, nan_color, v_min, v_max);
+			T_Src t_min = 0, t_max = 0;
+			for (i32 y = 0; y < img.rows; ++y) {
+				table.template row<false>(img.ptr<T_Src>(y), img.cols, idxs, res.ptr<Vec3b>(y), t_min, t_max);
+			}
+		}
+	};
+
+	/**
+	map raw values to BGR through a color map, range is taken from (and updated into) "range"
+	@param img [in] single channel mat (any depth)
+	@param lut [in] 256 entries of color map (see vis_colormap_lut)
+	@param range [in, out] range mode / state
+	@param res [out] variable with Mat type (CV_8UC3)
+	@param nan_color [in] color of NaN
+	@return
+	**/
+	inline void vis_colorize(const Mat& img, const Vec3b* lut, s_vis_range& range, Mat& res, const Vec3b& nan_color = Vec3b::all(0))
+	{
+		assert(img.channels() == 1);
+		const Mat src = img;		//keep source alive if res is img
+		res.create(src.size(), CV_8UC3);
+		double frame_min = 0., frame_max = 0.;
+		bool track = vis_range_update(src, range);
+		depth_dispatch<s_vis_colorize_kernel>::get(src.depth())(src, lut, nan_color, track, range.m_min, range.m_max, res, frame_min, frame_max);
+		if (track) {
+			range.update(frame_min, frame_max);
+		}
+	}
+
+	/**
+	map values of a lazy generator (s_range_gen, s_axis_gen, ...) to BGR, values are generated row by row into the colorization (no source mat)
+	@param gen [in] generator
+	@param lut [in] 256 entries of color map (see vis_colormap_lut)
+	@param range [in, out] range mode / state (min / max and percentile modes use the exact min / max of the generator)
+	@param res [out] variable with Mat type (CV_8UC3)
+	@param nan_color [in] color of NaN
+	@return
+	**/
+	template<typename T_Gen, typename = typename T_Gen::t_val>
+	inline void vis_colorize(const T_Gen& gen, const Vec3b* lut, s_vis_range& range, Mat& res, const Vec3b& nan_color = Vec3b::all(0))
+	{
+		typedef typename T_Gen::t_val T_Src;
+		if (range.m_mode != s_vis_range::range_fixed) {
+			double frame_min = 0., frame_max = 0.;
+			gen.minmax(frame_min, frame_max);
+			range.update(frame_min, frame_max);
+		}
+		res.create(gen.size(), CV_8UC3);
+		const s_vis_colorize_table<T_Src> table(lut, nan_color, range.m_min, range.m_max);
+		gen_for_each_row(gen, [&](const i32& y, const T_Src* p_src) {
+			T_Src t_min = 0, t_max = 0;
+			i32 idxs[256];
+			register auto p_res = res.ptr<Vec3b>(y);
+			for (i32 x = 0; x < res.cols; x += 256) {
+				table.template row<false>(p_src + x, min(256, res.cols - x), idxs, p_res + x, t_min, t_max);
+			}
+		});
+	}
+
+	/**
+	map raw values to BGR through a color map
+	@param img [in] single channel mat (any depth)
+	@param colormap [in] cv::ColormapTypes or vis_colormap_gray
+	@param range [in, out] range mode / state
+	@param res [out] variable with Mat type (CV_8UC3)
+	@return
+	**/
+	inline void vis_colorize(const Mat& img, const int& colormap, s_vis_range& range, Mat& res)
+	{
+		vis_colorize(img, vis_colormap_lut(colormap), range, res);
+	}
+
+	inline Mat vis_colorize(const Mat& img, const int& colormap, s_vis_range& range)
+	{
+		Mat res;
+		vis_colorize(img, colormap, range, res);
+		return res;
+	}
+
+	/*
+	layout of raw values: plain values are colorized by a color map, native sensor formats are converted to BGR
+	*/
+	enum e_vis_format {
+		vis_format_values,			//single channel values (any depth)
+		vis_format_nv12,			//Y plane (h rows) followed by interleaved UV plane (h / 2 rows), CV_8U with h * 3 / 2 rows
+		vis_format_bayer_rggb,		//Bayer mosaic (CV_8U / CV_16U), named by its top-left 2x2 quad
+		vis_format_bayer_bggr,
+		vis_format_bayer_grbg,
+		vis_format_bayer_gbrg,
+	};
+
+	inline bool vis_format_is_bayer(const int& format) {
+		return format >= vis_format_bayer_rggb && format <= vis_format_bayer_gbrg;
+	}
+
+	/**
+	get channel of a pixel of a Bayer mosaic
+	@return 0: B, 1: G, 2: R (index in BGR)
+	**/
+	inline int vis_bayer_channel(const int& format, const int& x, const int& y) {
+		//location of R in the 2x2 quad
+		static const int rxs[] = { 0, 1, 1, 0 }, rys[] = { 0, 1, 0, 1 };
+		int rx = rxs[format - vis_format_bayer_rggb], ry = rys[format - vis_format_bayer_rggb];
+		int dx = (x & 1) != rx, dy = (y & 1) != ry;
+		return dx == dy ? (dx ? 0 : 2) : 1;
+	}
+
+	/**
+	get size of image held by raw values of a format (e.g. h x w of NV12 buffer with h * 3 / 2 rows)
+	**/
+	inline Size vis_format_size(const Mat& raw, const int& format) {
+		assert(format != vis_format_nv12 || raw.rows % 3 == 0);
+		return format == vis_format_nv12 ? Size(raw.cols, raw.rows * 2 / 3) : raw.size();
+	}
+
+	/**
+	get image of raw values of a format (Y plane of NV12, which is a view of raw, UV plane follows its rows)
+	**/
+	inline Mat vis_format_image(const Mat& raw, const int& format) {
+		assert(format != vis_format_nv12 || raw.rows % 3 == 0);
+		return format == vis_format_nv12 ? raw.rowRange(0, raw.rows * 2 / 3) : raw;
+	}
+
+	/*
+	colorization policy: color map (or custom table) + range, e.g. of raw-only viewer ingest (viewer::img_show_cache)
+	*/
+	class s_vis_policy {
+	public:
+		int m_colormap;						//cv::ColormapTypes or vis_colormap_gray
+		const Vec3b* m_lut = 0;				//custom table of 256 entries (overrides m_colormap, must outlive the policy)
+		s_vis_range m_range;
+		Vec3b m_nan_color = Vec3b::all(0);
+		int m_format = vis_format_values;	//e_vis_format (native formats are converted, color map / range are not used)
+		int m_bits = 8;						//significant bits of Bayer samples (e.g. 10 for RG10 in CV_16U)
+
+		s_vis_policy(const int& colormap = COLORMAP_JET, const s_vis_range& range = s_vis_range(s_vis_range::range_minmax))
+			: m_colormap(colormap), m_range(range) {
+		}
+
+		s_vis_policy(const Vec3b* lut, const s_vis_range& range = s_vis_range(s_vis_range::range_minmax))
+			: m_colormap(vis_colormap_gray), m_lut(lut), m_range(range) {
+		}
+
+		inline const Vec3b* lut() const {
+			return m_lut ? m_lut : vis_colormap_lut(m_colormap);
+		}
+
+		/**
+		NV12 frames (CV_8U, h * 3 / 2 rows), converted to BGR (BT.601) on demand
+		**/
+		static inline s_vis_policy nv12() {
+			s_vis_policy res;
+			res.m_format = vis_format_nv12;
+			return res;
+		}
+
+		/**
+		Bayer frames (CV_8U / CV_16U), demosaiced on demand
+		@param format [in] vis_format_bayer_*
+		@param bits [in] significant bits of samples
+		@return
+		**/
+		static inline s_vis_policy bayer(const int& format = vis_format_bayer_rggb, const int& bits = 10) {
+			assert(vis_format_is_bayer(format));
+			s_vis_policy res;
+			res.m_format = format;
+			res.m_bits = bits;
+			return res;
+		}
+
+		/**
+		range statistics of a frame (min / max or percentile) without changing state, apply them by m_range.update
+		(thread safe as long as the policy is not modified, e.g. for prefetching)
+		**/
+		inline void frame_range(const Mat& img, double& frame_min, double& frame_max) const {
+			s_vis_range range = m_range;
+			if (range.m_mode != s_vis_range::range_percentile) {
+				range.m_mode = s_vis_range::range_minmax;
+			}
+			depth_dispatch<s_vis_range_kernel>::get(img.depth())(img, range, frame_min, frame_max);
+		}
+
+		/**
+		update range with a frame (pre-pass only, see vis_range_update)
+		**/
+		inline void update_range(const Mat& img) {
+			if (vis_range_update(img, m_range)) {
+				//range_running: the min / max is tracked by a separate pass since not all pixels are colorized
+				double frame_min = 0., frame_max = 0.;
+				depth_dispatch<s_vis_range_kernel>::get(img.depth())(img, m_range, frame_min, frame_max);
+				m_range.update(frame_min, frame_max);
+			}
+		}
+	};
+
+	/*
+	colorization of sampled pixels (see depth_dispatch)
+	*/
+	template<typename T_Src>
+	struct s_vis_colorize_sampled_kernel {
+		static inline void run(const Mat& img, const Vec3b* lut, const Vec3b& nan_color, const double& v_min, const double& v_max,
+			const int* p_xs, const i32& x_start, const i32& x_end, const int* p_ys, const i32& y_start, const i32& y_end, Mat& res) {
+			const s_vis_colorize_table<T_Src> table(lut, nan_color, v_min, v_max);
+			register i32 cols = x_end - x_start;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+			emat_omp{
+				T_Src t_min = 0, t_max = 0;
+				vector<T_Src> buf(max(cols, 0));
+				vector<i32> idxs(max(cols, 0));
+				for (i32 y = emat_omp_offset_range(y_start, y_end), y_len = emat_omp_offset_next_range(y_start, y_end); y < y_len; ++y) {
+					register auto p_src = img.ptr<T_Src>(p_ys[y]);
+					for (i32 x = 0; x < cols; ++x) {
+						buf[x] = p_src[p_xs[x_start + x]];
+					}
+					table.template row<false>(buf.data(), cols, idxs.data(), res.ptr<Vec3b>(y) + x_start, t_min, t_max);
+				}
+			}
+		}
+	};
+
+	/*
+	NV12 to BGR of sampled pixels (BT.601 limited range, fixed point as cv::cvtColor)
+	*/
+	struct s_vis_nv12_sampled_kernel {
+		static inline u8 sat(const i32& v) {
+			return (u8)(v < 0 ? 0 : (v > 255 ? 255 : v));
+		}
+
+		static inline void run(const Mat& img, const int* p_xs, const i32& x_start, const i32& x_end, const int* p_ys, const i32& y_start, const i32& y_end, Mat& res) {
+			const i32 shift = 20, half = 1 << (shift - 1);
+			const i32 cy = 1220542, cvr = 1673527, cvg = -852492, cug = -409993, cub = 2116026;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+			emat_omp{
+				for (i32 y = emat_omp_offset_range(y_start, y_end), y_len = emat_omp_offset_next_range(y_start, y_end); y < y_len; ++y) {
+					register auto p_y = img.ptr<u8>(p_ys[y]);
+					register auto p_uv = img.data + (size_t)(img.rows + p_ys[y] / 2) * img.step[0];	//UV plane follows the Y plane
+					register auto p_res = res.ptr<Vec3b>(y);
+					for (i32 x = x_start; x < x_end; ++x) {
+						i32 sx = p_xs[x];
+						i32 c = max((i32)p_y[sx] - 16, 0) * cy, d = (i32)p_uv[sx & ~1] - 128, e = (i32)p_uv[(sx & ~1) + 1] - 128;
+						p_res[x] = Vec3b(sat((c + cub * d + half) >> shift), sat((c + cug * d + cvg * e + half) >> shift), sat((c + cvr * e + half) >> shift));
+					}
+				}
+			}
+		}
+	};
+
+	/*
+	Bayer to BGR of sampled pixels (colors of the 2x2 quad containing the pixel, G is averaged)
+	*/
+	template<typename T_Src>
+	struct s_vis_bayer_sampled_kernel {
+		static inline void run(const Mat& img, const int& format, const int& bits, const int* p_xs, const i32& x_start, const i32& x_end, const int* p_ys, const i32& y_start, const i32& y_end, Mat& res) {
+			//bits beyond the depth of samples are ignored (e.g. default 10 bits of a CV_8U mosaic)
+			const int shift = max(min(bits, (int)sizeof(T_Src) * 8) - 8, 0);
+			int b_idx = 0;						//index in quad: 0 (0, 0), 1 (1, 0), 2 (0, 1), 3 (1, 1)
+			for (int i = 0; i < 4; ++i) {
+				if (vis_bayer_channel(format, i & 1, i >> 1) == 0) b_idx = i;
+			}
+			const int r_idx = 3 - b_idx;
+			const i32 x_max = (img.cols & ~1) - 2, y_max = (img.rows & ~1) - 2;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+			emat_omp{
+				for (i32 y = emat_omp_offset_range(y_start, y_end), y_len = emat_omp_offset_next_range(y_start, y_end); y < y_len; ++y) {
+					i32 qy = min(p_ys[y] & ~1, y_max);
+					register auto p_src0 = img.ptr<T_Src>(qy);
+					register auto p_src1 = img.ptr<T_Src>(qy + 1);
+					register auto p_res = res.ptr<Vec3b>(y);
+					for (i32 x = x_start; x < x_end; ++x) {
+						i32 qx = min(p_xs[x] & ~1, x_max);
+						i32 q[4] = { (i32)p_src0[qx], (i32)p_src0[qx + 1], (i32)p_src1[qx], (i32)p_src1[qx + 1] };
+						i32 g = (q[0] + q[1] + q[2] + q[3] - q[b_idx] - q[r_idx] + 1) >> 1;
+						p_res[x] = Vec3b((u8)min(q[b_idx] >> shift, 255), (u8)min(g >> shift, 255), (u8)min(q[r_idx] >> shift, 255));
+					}
+				}
+			}
+		}
+	};
+
+	/**
+	nearest neighbor resampling fused with colorization, only sampled pixels are colorized:
+	res(y, x) = color(img(p_ys[y], p_xs[x])) for x in [x_start, x_end), y in [y_start, y_end)
+	@param img [in] single channel mat (any depth), Y plane of NV12 (see vis_format_image) or Bayer mosaic by policy.m_format
+	@param policy [in] color map / range (range is not updated)
+	@param p_xs [in] source column of each column of res
+	@param x_start [in] first column of res
+	@param x_end [in] end column of res
+	@param p_ys [in] source row of each row of res
+	@param y_start [in] first row of res
+	@param y_end [in] end row of res
+	@param res [out] CV_8UC3 (allocated by caller, other pixels are kept)
+	@return
+	**/
+	inline void vis_colorize_sampled(const Mat& img, const s_vis_policy& policy,
+		const int* p_xs, const i32& x_start, const i32& x_end, const int* p_ys, const i32& y_start, const i32& y_end, Mat& res) {
+		assert(img.channels() == 1 && res.type() == CV_8UC3);
+		if (policy.m_format == vis_format_nv12) {
+			assert(img.depth() == CV_8U);
+			s_vis_nv12_sampled_kernel::run(img, p_xs, x_start, x_end, p_ys, y_start, y_end, res);
+		}
+		else if (vis_format_is_bayer(policy.m_format)) {
+			assert((img.depth() == CV_8U || img.depth() == CV_16U) && img.cols >= 2 && img.rows >= 2);
+			(img.depth() == CV_8U ? &s_vis_bayer_sampled_kernel<u8>::run : &s_vis_bayer_sampled_kernel<u16>::run)(img, policy.m_format, policy.m_bits,
+				p_xs, x_start, x_end, p_ys, y_start, y_end, res);
+		}
+		else {
+			depth_dispatch<s_vis_colorize_sampled_kernel>::get(img.depth())(img, policy.lut(), policy.m_nan_color, policy.m_range.m_min, policy.m_range.m_max,
+				p_xs, x_start, x_end, p_ys, y_start, y_end, res);
+		}
+	}
+
+	/**
+	colorize a region with the current range of a policy (range is not updated)
+	@param img [in] single channel mat (any depth)
+	@param policy [in] color map / range
+	@param res [out] CV_8UC3 with size of img (allocated by caller, e.g. a tile)
+	@return
+	**/
+	inline void vis_colorize(const Mat& img, const s_vis_policy& policy, Mat& res) {
+		assert(img.channels() == 1 && res.type() == CV_8UC3 && res.size() == img.size());
+		double frame_min = 0., frame_max = 0.;
+		depth_dispatch<s_vis_colorize_kernel>::get(img.depth())(img, policy.lut(), policy.m_nan_color, false, policy.m_range.m_min, policy.m_range.m_max, res, frame_min, frame_max);
+	}
+
+	/*
+	batch colorization: many (input, policy) jobs run as one parallel pass over chunks of rows of all jobs,
+	outputs are buffers kept from batch to batch, or views given by the caller (e.g. tiles of a s_mosaic)
+	[Example]:
+	s_vis_batch batch;
+	batch.clear();
+	for (int i = 0; i < (int)tensors.size(); ++i) batch.add(tensors[i], policies[i]);	//ranges of policies are updated
+	const Mat& dashboard = batch.run(mosaic, 8);										//tiles of same size are written in place
+	*/
+	class s_vis_batch {
+	private:
+		class s_job {
+		public:
+			Mat img;
+			s_vis_policy policy;
+			s_vis_policy* p_policy = 0;				//policy of caller (updated range is written back)
+			Mat res;
+			bool external = false;					//res is a view given by caller
+		};
+		class s_chunk {
+		public:
+			int job;
+			int y_start;
+			int y_end;
+		};
+		vector<s_job> m_jobs;						//kept between batches (buffers of res are reused)
+		int m_cnt = 0;
+		vector<int> m_idxs;							//identity map (native formats)
+		vector<vector<i32>> m_scratch;				//index row of each thread (values), sized once per run
+		vector<s_chunk> m_chunks;					//work items of all jobs
+
+	public:
+		/**
+		start a new batch (buffers are kept)
+		**/
+		inline void clear() {
+			m_cnt = 0;
+		}
+
+		/**
+		add a job
+		@param img [in] raw values / native format of policy
+		@param policy [in,out] color map / range (range is updated by run, a policy may be shared by jobs, then the last update wins)
+		@param dst [in] CV_8UC3 destination of size of image (empty: buffer of batch, see res)
+		@return index of job
+		**/
+		inline int add(const Mat& img, s_vis_policy& policy, const Mat& dst = Mat()) {
+			if (m_cnt == (int)m_jobs.size()) {
+				m_jobs.emplace_back();
+			}
+			auto& job = m_jobs[m_cnt];
+			job.img = img;
+			job.policy = policy;
+			job.p_policy = &policy;
+			if (!dst.empty()) {
+				assert(dst.type() == CV_8UC3 && dst.size() == vis_format_size(img, policy.m_format));
+				job.res = dst;
+				job.external = true;
+			}
+			else if (job.external) {
+				job.res.release();
+				job.external = false;
+			}
+			return m_cnt++;
+		}
+
+		/**
+		colorize all jobs
+		@param chunk_rows [in] rows of a work item (items of all jobs are scheduled together)
+		@return
+		**/
+		inline void run(const int& chunk_rows = 16) {
+			register i32 cnt = m_cnt;
+			//range pre-pass (one job per thread)
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt) schedule(dynamic)
+#endif
+			for (i32 i = 0; i < cnt; ++i) {
+				auto& job = m_jobs[i];
+				if (job.policy.m_format == vis_format_values) {
+					job.policy.update_range(job.img);
+				}
+			}
+			m_chunks.clear();
+			int len_max = 0;
+			for (i32 i = 0; i < cnt; ++i) {
+				auto& job = m_jobs[i];
+				*job.p_policy = job.policy;
+				job.policy.m_lut = job.policy.lut();			//resolved once, not per chunk
+				Size size = vis_format_size(job.img, job.policy.m_format);
+				if (!job.external) {
+					job.res.create(size, CV_8UC3);
+				}
+				len_max = max(len_max, max(size.width, size.height));
+				for (int y = 0; y < size.height; y += chunk_rows) {
+					m_chunks.push_back({ i, y, min(y + chunk_rows, size.height) });
+				}
+			}
+			if ((int)m_idxs.size() < len_max) {
+				m_idxs.resize(len_max);
+				for (int i = 0; i < len_max; ++i) {
+					m_idxs[i] = i;
+				}
+			}
+			m_scratch.resize(emat_omp_cnt);
+			for (auto& scratch : m_scratch) {
+				if ((int)scratch.size() < len_max) {
+					scratch.resize(len_max);
+				}
+			}
+			register i32 chunks_len = (i32)m_chunks.size();
+			//kernels of chunks are serial (nested in this region)
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt) schedule(dynamic)
+#endif
+			for (i32 c = 0; c < chunks_len; ++c) {
+				auto& chunk = m_chunks[c];
+				auto& job = m_jobs[chunk.job];
+				if (job.policy.m_format == vis_format_values) {
+					//rows are colorized in place (no gather through identity maps)
+#ifdef _OPENMP
+					i32* idxs = m_scratch[omp_get_thread_num()].data();
+#else
+					i32* idxs = m_scratch[0].data();
+#endif
+					Mat res_rows = job.res.rowRange(chunk.y_start, chunk.y_end);
+					depth_dispatch<s_vis_colorize_rows_kernel>::get(job.img.depth())(job.img.rowRange(chunk.y_start, chunk.y_end), job.policy.m_lut,
+						job.policy.m_nan_color, job.policy.m_range.m_min, job.policy.m_range.m_max, idxs, res_rows);
+				}
+				else {
+					vis_colorize_sampled(vis_format_image(job.img, job.policy.m_format), job.policy, m_idxs.data(), 0, job.res.cols, m_idxs.data(), chunk.y_start, chunk.y_end, job.res);
+				}
+			}
+		}
+
+		/**
+		colorize all jobs into tiles of a mosaic (tiles of the largest size are written in place, others are resized into their cells)
+		@param mosaic [in,out] mosaic (layout is kept while sizes do not change)
+		@param cols [in] the max count of images can be put in each colume
+		@return mosaic
+		**/
+		inline const Mat& run(s_mosaic& mosaic, const u32& cols) {
+			vector<Size> sizes(m_cnt);
+			for (int i = 0; i < m_cnt; ++i) {
+				sizes[i] = vis_format_size(m_jobs[i].img, m_jobs[i].policy.m_format);
+			}
+			mosaic.reserve(sizes, cols, CV_8UC3);
+			for (int i = 0; i < m_cnt; ++i) {
+				auto& job = m_jobs[i];
+				if (mosaic.tile_scale(i) == 1) {
+					job.res = mosaic.tile_mat(i);
+					job.external = true;
+				}
+				else if (job.external) {
+					job.res.release();
+					job.external = false;
+				}
+			}
+			run();
+			register i32 cnt = m_cnt;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt) schedule(dynamic)
+#endif
+			for (i32 i = 0; i < cnt; ++i) {
+				if (mosaic.tile_scale(i) != 1) {
+					Mat dst = mosaic.tile_mat(i);
+					resize(m_jobs[i].res, dst, dst.size(), 0, 0, INTER_NEAREST);
+				}
+			}
+			return mosaic.mat();
+		}
+
+		/**
+		get output of a job
+		**/
+		inline const Mat& res(const int& idx) const {
+			return m_jobs[idx].res;
+		}
+
+		inline int size() const {
+			return m_cnt;
+		}
+	};
+
+	/*
+	default range of vis_* functions: U8 is displayed as is, other types are normalized by min / max
+	*/
+	inline s_vis_range vis_default_range(const Mat& img) {
+		return img.depth() == CV_8U ? s_vis_range(s_vis_range::range_fixed, 0., 255.) : s_vis_range(s_vis_range::range_minmax);
+	}
+
 	/**
 	apply COLORMAP_JET
 	@param img [in] array with Mat type
+	@param range [in, out] range mode / state (e.g. range_running for video)
 	@param res [out] variable with Mat type
 	@return
 	**/
-	inline void vis_colormap_jet(const Mat& img, Mat& res)
+	inline void vis_colormap_jet(const Mat& img, s_vis_range& range, Mat& res)
 	{
 		assert(img.channels() == 1);
 		if (img.channels() == 1) {
-			if (img.type() != CV_8U) {
-				normalize(img, res, 0, 255, NORM_MINMAX, CV_8U);
-			}
-			else {
-				res = img;
-			}
-			applyColorMap(res, res, COLORMAP_JET);
+			vis_colorize(img, COLORMAP_JET, range, res);
 		}
 		else {
 			res = img.clone();
 		}
 	}
 
+	/**
+	apply COLORMAP_JET
+	@param img [in] array with Mat type
+	@param res [out] variable with Mat type
+	@return
+	**/
+	inline void vis_colormap_jet(const Mat& img, Mat& res)
+	{
+		auto range = vis_default_range(img);
+		vis_colormap_jet(img, range, res);
+	}
+
 	/**
 	apply COLORMAP_JET
 	@param img [in] array with Mat type
@@ -151,22 +1233,25 @@ namespace emat {
 	}
 
 	/**
-	apply "U8"
+	apply "U8" (CV_8UC3)
 	**/
-	inline void vis_gray(const Mat& img, Mat& res)
+	inline void vis_gray(const Mat& img, s_vis_range& range, Mat& res)
 	{
 		assert((img.channels() == 1));
-		if (img.type() != CV_8U) {
-			normalize(img, res, 0, 255, NORM_MINMAX, CV_8U);
-		}
-		else {
-			res = img;
-		}
-		cvtColor(res, res, COLOR_BGR2RGB);
+		vis_colorize(img, vis_colormap_gray, range, res);
+	}
+
+	/**
+	apply "U8" (CV_8UC3)
+	**/
+	inline void vis_gray(const Mat& img, Mat& res)
+	{
+		auto range = vis_default_range(img);
+		vis_gray(img, range, res);
 	}
 
 	/**
-	apply "U8"
+	apply "U8" (CV_8UC3)
 	**/
 	inline Mat vis_gray(const Mat& img)
 	{
@@ -204,6 +1289,108 @@ namespace emat {
 		return res;
 	}
 
+	/*
+	lookup table engine for 16-bit inputs: 65536 BGR entries, rebuilt only when parameters change
+	*/
+	class s_lut_u16 {
+	private:
+		vector<u32> m_table;			//BGR in the first 3 bytes of each entry (allows 4-byte stores)
+		Vec<double, 6> m_key;
+		bool m_valid = false;
+
+	public:
+		typedef Vec<double, 6> t_key;
+
+		/**
+		build table with a custom mapping (skipped if key did not change)
+		@param key [in] parameters the mapping depends on
+		@param func [in] Vec3b func(const u16& idx), idx is the 16-bit pattern of the source value
+		@return whether table was rebuilt
+		**/
+		template<typename T_Func>
+		inline bool build(const t_key& key, const T_Func& func) {
+			if (m_valid && key == m_key) return false;
+			m_table.resize(65536);
+			register auto p_table = m_table.data();
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+			for (i32 i = 0; i < 65536; ++i) {
+				Vec3b color = func((u16)i);
+				u32 v = 0;
+				memcpy(&v, color.val, 3);
+				p_table[i] = v;
+			}
+			m_key = key;
+			m_valid = true;
+			return true;
+		}
+
+		/**
+		build table from a 256 entries color map (any cv::ColormapTypes through vis_colormap_lut, or custom)
+		@param lut [in] 256 entries of color map
+		@param v_min [in] value mapped to lut[0] (values below are clamped)
+		@param v_max [in] value mapped to lut[255] (values above are clamped)
+		@return whether table was rebuilt
+		**/
+		template<typename T_Src>
+		inline bool build(const Vec3b* lut, const double& v_min, const double& v_max) {
+			static_assert(sizeof(T_Src) == 2, "16-bit type required");
+			const double v_scale = (v_max > v_min) ? 255. / (v_max - v_min) : 0.;
+			return build(t_key((double)(size_t)lut, v_min, v_max, (double)sys_to_cv_type<T_Src>(), 0., 0.), [&](const u16& idx) -> Vec3b {
+				double t = ((double)(T_Src)idx - v_min) * v_scale;
+				return lut[(int)(t > 0 ? (t < 255 ? t : 255) : 0)];
+			});
+		}
+
+		/**
+		build table from a 256 entries color map and a range (see s_vis_range / vis_range_update)
+		**/
+		template<typename T_Src>
+		inline bool build(const Vec3b* lut, const s_vis_range& range) {
+			return build<T_Src>(lut, range.m_min, range.m_max);
+		}
+
+		/**
+		invalidate table (next build always rebuilds)
+		**/
+		inline void invalidate() {
+			m_valid = false;
+		}
+
+		/**
+		apply table: one gather and one store per pixel
+		@param src [in] 16-bit single channel mat
+		@param res [out] variable with Mat type (CV_8UC3)
+		@return
+		**/
+		template<typename T_Src>
+		inline void apply(const Mat& src, Mat& res) const {
+			static_assert(sizeof(T_Src) == 2, "16-bit type required");
+			assert(m_valid && src.channels() == 1 && src.elemSize() == 2);
+			const Mat img = src;		//keep source alive if res is src
+			res.create(img.size(), CV_8UC3);
+			register auto p_table = m_table.data();
+			register i32 rows = img.rows, cols = img.cols;
+			if (cols == 0) return;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(emat_omp_cnt)
+#endif
+			emat_omp{
+				for (i32 y = emat_omp_offset_range(0, rows), y_end = emat_omp_offset_next_range(0, rows); y < y_end; ++y) {
+					register auto p_src = img.ptr<u16>(y);
+					register auto p_res = res.ptr<u8>(y);
+					register i32 x = 0;
+					//4-byte stores overlap the next pixel, which is overwritten right after
+					for (; x < cols - 1; ++x) {
+						memcpy(p_res + x * 3, p_table + p_src[x], 4);
+					}
+					memcpy(p_res + x * 3, p_table + p_src[x], 3);
+				}
+			}
+		}
+	};
+
 	/**
 	Convert Mat with uint16 type into Mat with gray type
 	@param gray_u16 [in] array with Mat type
@@ -217,21 +1404,32 @@ namespace emat {
 #if emat_security_protection_en
 		type_check<T_Src>(gray_u16, true);
 #endif
-		res = Mat(gray_u16.size(), CV_8UC3);
-		auto src = (T_Src*)gray_u16.data;
-		u8* dst = res.data;
-		auto src_len = (int32_t)gray_u16.total();
-
+		static thread_local s_lut_u16 lut;
 		i16 v_balance = balance - 640;
 		register u16 v_mean = (u16)cv::mean(gray_u16).val[0];
 		v_mean = ((i16)v_mean <= v_balance) ? 1 : (i16)v_mean - v_balance;
 		register u16 v_mean_mul_2 = v_mean * 2;
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(emat_omp_cnt)
+		lut.build(s_lut_u16::t_key(v_mean, v_mean_mul_2, (double)sys_to_cv_type<T_Src>(), 0., 0., 0.), [&](const u16& idx) -> Vec3b {
+			auto v_src = (T_Src)idx;
+			return Vec3b::all((u8)((v_src < v_mean_mul_2) ? (128 * v_src) / v_mean : 255));
+		});
+		lut.apply<T_Src>(gray_u16, res);
+	}
+
+	/**
+	Convert Mat with uint16 type into Mat with gray type (robust auto-contrast, e.g. s_vis_range::percentile())
+	@param gray_u16 [in] array with Mat type
+	@param range [in, out] range mode / state
+	@param res [out] variable with Mat type
+	@return
+	**/
+	template<typename T_Src>
+	inline void vis_gray_u16(const Mat& gray_u16, s_vis_range& range, Mat& res)
+	{
+#if emat_security_protection_en
+		type_check<T_Src>(gray_u16, true);
 #endif
-		for (i32 i = 0; i < src_len; ++i) {
-			memset(dst + i * 3, (src[i] < v_mean_mul_2) ? (128 * src[i]) / v_mean : 255, 3);
-		}
+		vis_gray(gray_u16, range, res);
 	}
 
 	template<typename T_Src>
@@ -266,28 +1464,20 @@ namespace emat {
 		type_check<T_Src>(dist_u16, true);
 #endif
 
-		static Mat color_map_u8_sl = vis_apply_color_map(range<u8>(255, -1, Size(16, 16)), COLORMAP_JET);
-		static Mat color_map_u8_ls = vis_apply_color_map(range<u8>(0, 1, Size(16, 16)), COLORMAP_JET);
-
+		static thread_local s_lut_u16 lut;
 		// Search By Table
-		res = Mat(dist_u16.size(), CV_8UC3);
-		register auto src = (T_Src*)dist_u16.data;
-		register uint8_t* dst = res.data;
-		register i32 src_len = (i32)dist_u16.total();
-		register u8* p_color_map = pseudo_max >= pseudo_min ? color_map_u8_sl.data : color_map_u8_ls.data;
+		register auto p_color_map = vis_colormap_lut(COLORMAP_JET);
+		register bool reversed = pseudo_max >= pseudo_min;
 		register u16 v_max = max(pseudo_max, pseudo_min), v_min = min(pseudo_max, pseudo_min), v_diff = v_max - v_min;
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(emat_omp_cnt)
-#endif
-		for (int i = 0; i < src_len; ++i) {
-			register auto v_src = src[i];
+		lut.build(s_lut_u16::t_key(v_min, v_max, reversed, (double)sys_to_cv_type<T_Src>(), 1., 0.), [&](const u16& idx) -> Vec3b {
+			auto v_src = (T_Src)idx;
 			if (v_min < v_src && v_src < v_max) {
-				memcpy(dst + i * 3, p_color_map + (int)(255 * (v_src - v_min) / v_diff) * 3, 3);
+				int color_idx = (int)(255 * (v_src - v_min) / v_diff);
+				return p_color_map[reversed ? 255 - color_idx : color_idx];
 			}
-			else {
-				memset(dst + i * 3, 0, 3);
-			}
-		}
+			return Vec3b::all(0);
+		});
+		lut.apply<T_Src>(dist_u16, res);
 	}
 
 	template<typename T_Src>
@@ -0,0 +1,198 @@
+/*****************************************************************//**
+ *      @file  emat_watch.h
+ *      @brief Provide watch sources (a mat / buffer / callback registered once, snapshotted by the viewer)
+ *
+ *  Detail Decsription starts here
+ *  [Example]:
+ *  s_seqlock lock;
+ *  Mat img(480, 640, CV_32F);
+ *  viewer.watch("img", img.size(), s_watch::ref(img, lock), s_vis_policy(COLORMAP_JET), texts);
+ *  while (true) {
+ *  	{
+ *  		s_seqlock::s_write_scope scope(lock);		//2 atomic increments on the hot path
+ *  		process(img);								//write into img in place
+ *  	}
+ *  	viewer.flush_events();							//or imgs_show, snapshots only visible windows at refresh rate
+ *  	waitKey(1);
+ *  }
+ *   @internal
+ *     Project
+ *     Created  10/19/2026
+ *    Revision  10/19/2026
+ *     Company
+ *   Copyright
+ *
+ * *******************************************************************/
+
+#ifndef EMAT_WATCH_H_
+#define EMAT_WATCH_H_
+
+#include "emat_core.hpp"
+#include <atomic>
+#include <functional>
+#include <thread>
+
+using namespace std;
+
+namespace emat {
+	/*
+	sequence lock: the producer brackets writes (never waits), readers copy and retry if a write overlapped
+	*/
+	class s_seqlock {
+	private:
+		atomic<u32> m_seq;
+
+	public:
+		/*
+		bracket writes during lifetime of scope
+		*/
+		class s_write_scope {
+		private:
+			s_seqlock& m_lock;
+		public:
+			s_write_scope(s_seqlock& lock) : m_lock(lock) {
+				m_lock.write_begin();
+			}
+			~s_write_scope() {
+				m_lock.write_end();
+			}
+		};
+
+		s_seqlock() : m_seq(0) {}
+
+		inline void write_begin() {
+			m_seq.fetch_add(1, memory_order_relaxed);
+			atomic_thread_fence(memory_order_release);
+		}
+
+		inline void write_end() {
+			m_seq.fetch_add(1, memory_order_release);
+		}
+
+		/**
+		start reading
+		@param seq [out] sequence to be checked by read_valid
+		@return false if a write is in progress
+		**/
+		inline bool read_begin(u32& seq) const {
+			seq = m_seq.load(memory_order_acquire);
+			return (seq & 1) == 0;
+		}
+
+		/**
+		whether data read since read_begin is consistent (no write overlapped)
+		**/
+		inline bool read_valid(const u32& seq) const {
+			atomic_thread_fence(memory_order_acquire);
+			return m_seq.load(memory_order_relaxed) == seq;
+		}
+	};
+
+	/*
+	source of a watched window, snapshotted by the viewer at its own cadence (nothing is done while the window is hidden)
+	*/
+	class s_watch {
+	public:
+		enum e_consistency {
+			consistency_tear,		//copied while the producer may write (cheapest, a snapshot may mix two frames)
+			consistency_seqlock,	//copied between write_end / write_begin of a s_seqlock (unchanged sequence: no copy at all)
+			consistency_snapshot,	//the callback of the producer supplies a consistent snapshot
+		};
+
+	private:
+		Mat m_src;								//header of producer memory (data is written in place by the producer)
+		const s_seqlock* m_seqlock = 0;
+		function<bool(Mat&)> m_snapshot_func;
+		e_consistency m_consistency = consistency_tear;
+		u32 m_seq_last = 1;						//sequence of last snapshot (odd: none yet)
+		int m_tries = 4;						//copies tried when writes overlap, the previous snapshot is kept if all of them fail
+		Mat m_back;								//buffer copies are written into, swapped with the snapshot once complete
+
+	public:
+		/**
+		watch a mat (the producer keeps writing into the same buffer, e.g. a preallocated frame)
+		**/
+		static inline s_watch ref(const Mat& mat) {
+			s_watch res;
+			res.m_src = mat;
+			res.m_consistency = consistency_tear;
+			return res;
+		}
+
+		static inline s_watch ref(const Mat& mat, const s_seqlock& lock) {
+			s_watch res = ref(mat);
+			res.m_seqlock = &lock;
+			res.m_consistency = consistency_seqlock;
+			return res;
+		}
+
+		/**
+		watch a buffer of the producer (must outlive the watch)
+		@param data [in] pointer of first pixel
+		@param size [in] size of image
+		@param type [in] cv type of pixels
+		@param step [in] bytes of a row (Mat::AUTO_STEP: continuous)
+		@param lock [in] seqlock of writes into data (0: tear allowed)
+		@return
+		**/
+		static inline s_watch buffer(const void* data, const Size& size, const int& type, const size_t& step = Mat::AUTO_STEP, const s_seqlock* lock = 0) {
+			s_watch res = ref(Mat(size, type, (void*)data, step));
+			if (lock) {
+				res.m_seqlock = lock;
+				res.m_consistency = consistency_seqlock;
+			}
+			return res;
+		}
+
+		/**
+		watch a producer callback
+		@param func [in] fills the given mat with a consistent snapshot (reuse its buffer if possible), false: unchanged since last call
+		@return
+		**/
+		static inline s_watch callback(const function<bool(Mat&)>& func) {
+			s_watch res;
+			res.m_snapshot_func = func;
+			res.m_consistency = consistency_snapshot;
+			return res;
+		}
+
+		inline e_consistency consistency() const {
+			return m_consistency;
+		}
+
+		/**
+		take a snapshot, copies are written into a back buffer and swapped with res once complete,
+		so res (referenced by the display) is never overwritten and the previous snapshot is kept if a copy fails
+		@param res [in,out] snapshot (buffers are swapped, kept as is if unchanged)
+		@return whether res was updated
+		**/
+		inline bool snapshot(Mat& res) {
+			if (m_consistency == consistency_snapshot) {
+				if (!m_snapshot_func(m_back) || m_back.empty()) return false;
+				swap(res, m_back);
+				return true;
+			}
+			if (m_consistency == consistency_tear) {
+				m_src.copyTo(m_back);
+				swap(res, m_back);
+				return true;
+			}
+			for (int i = 0; i < m_tries; ++i) {
+				u32 seq;
+				if (!m_seqlock->read_begin(seq)) {
+					this_thread::yield();
+					continue;
+				}
+				if (seq == m_seq_last && !res.empty()) return false;
+				m_src.copyTo(m_back);
+				if (m_seqlock->read_valid(seq)) {
+					m_seq_last = seq;
+					swap(res, m_back);
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+}
+#endif
@@ -0,0 +1,183 @@
+#include <opencv2/opencv.hpp>
+#include <opencv2/core.hpp>
+#include "../../src/eunit/emat/emat_visual.hpp"
+#include "../../src/eunit/emat/emat_viewer.hpp"
+#include <chrono>
+#include <fstream>
+#include <stdio.h>
+
+using namespace std;
+using namespace cv;
+using namespace emat;
+
+/*
+viewer without windows: the UI hooks are overridden, mouse callbacks are kept to be driven by scripts
+*/
+class s_headless_viewer : public viewer {
+public:
+	MouseCallback m_callback = 0;
+	void* m_callback_param = 0;
+	Size m_win_size;
+
+	~s_headless_viewer() {
+		destroy_all();		//hooks of base are used by its destructor
+	}
+
+	inline void event(const int& event, const int& x, const int& y, const int& flags) {
+		m_callback(event, x, y, flags, m_callback_param);
+	}
+
+protected:
+	inline void destroy_window(const string& /*win_name*/) {}
+	inline void named_window(const string& /*win_name*/) {}
+	inline void resize_window(const string& /*win_name*/, const int& width, const int& height) {
+		m_win_size = Size(width, height);
+	}
+	inline void img_show(const string& /*win_name*/, const Mat& /*img*/) {}
+	inline Rect get_window_image_rect(const string& /*win_name*/) {
+		return Rect(Point(0, 0), m_win_size);
+	}
+	inline bool is_window_visible(const string& /*win_name*/) {
+		return true;
+	}
+	inline void set_mouse_callback(const string& /*win_name*/, const MouseCallback& callback, void* params) {
+		m_callback = callback;
+		m_callback_param = params;
+	}
+	inline int get_mouse_wheel_delta(const int& flag) {
+		return (flag >> 16);	//same encoding as cv::getMouseWheelDelta
+	}
+};
+
+/*
+mouse event of a script
+*/
+class s_bench_event {
+public:
+	int event;
+	int x;
+	int y;
+	int flags;
+};
+
+/**
+drag from the center along a circle (pan)
+**/
+vector<s_bench_event> script_drag(const Size& win_size, const int& cnt) {
+	vector<s_bench_event> res;
+	int cx = win_size.width / 2, cy = win_size.height / 2;
+	float radius = min(win_size.width, win_size.height) * 0.25f;
+	res.push_back({ EVENT_LBUTTONDOWN, cx, cy, EVENT_FLAG_LBUTTON });
+	for (int i = 0; i < cnt; ++i) {
+		float a = 6.2831853f * i / cnt;
+		res.push_back({ EVENT_MOUSEMOVE, cx + (int)(radius * sin(a)), cy + (int)(radius * (1.f - cos(a))), EVENT_FLAG_LBUTTON });
+	}
+	res.push_back({ EVENT_LBUTTONUP, cx, cy, 0 });
+	return res;
+}
+
+/**
+zoom in and out again at a point (wheel burst)
+**/
+vector<s_bench_event> script_wheel(const Size& win_size, const int& cnt) {
+	vector<s_bench_event> res;
+	for (int i = 0; i < cnt; ++i) {
+		res.push_back({ EVENT_MOUSEWHEEL, win_size.width / 3, win_size.height / 3, (i < cnt / 2 ? 120 : -120) << 16 });
+	}
+	return res;
+}
+
+/**
+move over the window row by row (tiptool)
+**/
+vector<s_bench_event> script_hover(const Size& win_size, const int& cnt) {
+	vector<s_bench_event> res;
+	int rows = 8;
+	for (int i = 0; i < cnt; ++i) {
+		int row = i * rows / cnt, col = i % (cnt / rows);
+		res.push_back({ EVENT_MOUSEMOVE, 1 + col * (win_size.width - 2) / (cnt / rows), 1 + row * (win_size.height - 2) / rows, 0 });
+	}
+	return res;
+}
+
+/**
+load a recorded script, one event per line: "event x y flags" (cv::MouseEventTypes / cv::MouseEventFlags)
+**/
+vector<s_bench_event> script_load(const string& file_name) {
+	vector<s_bench_event> res;
+	ifstream file(file_name);
+	s_bench_event e;
+	while (file >> e.event >> e.x >> e.y >> e.flags) {
+		res.push_back(e);
+	}
+	return res;
+}
+
+/**
+get percentile of sorted latencies
+**/
+double percentile(const vector<double>& sorted, const double& p) {
+	return sorted.size() ? sorted[min((size_t)(p * (sorted.size() - 1) + 0.5), sorted.size() - 1)] : 0.;
+}
+
+int main(int argc, const char** argv)
+{
+	//usage: bench_interaction [recorded script], results are printed as json
+	const int cnt = 200;
+	const Size win_sizes[] = { Size(640, 480), Size(1920, 1080) };
+	const Size img_sizes[] = { Size(640, 480), Size(4096, 3072) };
+	const int types[] = { CV_8UC3, CV_16U, CV_32F };
+	const char* type_names[] = { "8UC3", "16U", "32F" };
+	const char* zoom_names[] = { "fit", "zoom", "grid" };		//view before each script: whole image, scale <= 0.25, values in grid cells
+	const int zoom_steps_max = 256;
+	vector<s_bench_event> recorded = argc > 1 ? script_load(argv[1]) : vector<s_bench_event>();
+
+	bool first = true;
+	printf("[\n");
+	for (auto& win_size : win_sizes) {
+		for (auto& img_size : img_sizes) {
+			for (int t = 0; t < (int)arr_len(types); ++t) {
+				Mat img_raw(img_size, types[t]);
+				randu(img_raw, Scalar::all(0), Scalar::all(255));
+				for (int z = 0; z < (int)arr_len(zoom_names); ++z) {
+					const char* script_names[] = { "drag", "wheel", "hover", "recorded" };
+					vector<s_bench_event> scripts[] = { script_drag(win_size, cnt), script_wheel(win_size, 40), script_hover(win_size, cnt), recorded };
+					for (int s = 0; s < (int)arr_len(scripts); ++s) {
+						if (scripts[s].size() == 0) continue;
+						s_headless_viewer viewer;
+						viewer.set_refresh_interval(0);			//every event is rendered (worst case, no coalescing)
+						if (types[t] == CV_8UC3) {
+							viewer.img_show_cache("bench", win_size, img_raw, img_raw, {});
+						}
+						else {
+							viewer.img_show_cache("bench", win_size, img_raw, s_vis_policy(COLORMAP_JET), {});
+						}
+						viewer.imgs_show(true);
+						//wheel into the center until the view of the record is reached
+						float scale_factor = 1.f;
+						bool grid_view = false;
+						viewer.get_view("bench", scale_factor, grid_view);
+						for (int i = 0; i < zoom_steps_max && ((z == 1 && scale_factor > 0.25f) || (z == 2 && !grid_view)); ++i) {
+							viewer.event(EVENT_MOUSEWHEEL, win_size.width / 2, win_size.height / 2, 120 << 16);
+							viewer.get_view("bench", scale_factor, grid_view);
+						}
+						vector<double> latencies;
+						latencies.reserve(scripts[s].size());
+						for (auto& e : scripts[s]) {
+							auto start = chrono::steady_clock::now();
+							viewer.event(e.event, e.x, e.y, e.flags);
+							latencies.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+						}
+						sort(latencies.begin(), latencies.end());
+						printf("%s\t{\"win\": [%d, %d], \"img\": [%d, %d], \"type\": \"%s\", \"zoom\": \"%s\", \"scale\": %.4f, \"grid\": %s, \"script\": \"%s\", \"events\": %d, \"p50_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f}",
+							first ? "" : ",\n", win_size.width, win_size.height, img_size.width, img_size.height, type_names[t], zoom_names[z], scale_factor, grid_view ? "true" : "false", script_names[s],
+							(int)latencies.size(), percentile(latencies, 0.5), percentile(latencies, 0.99), latencies.back());
+						first = false;
+					}
+				}
+			}
+		}
+	}
+	printf("\n]\n");
+	return 0;
+}
@@ -0,0 +1,92 @@
+#include <opencv2/opencv.hpp>
+#include <opencv2/core.hpp>
+#include "../../src/eunit/emat/emat_visual.hpp"
+#include "../../src/eunit/emat/emat_viewer.hpp"
+#include "../../src/eunit/emat/emat_io.hpp"
+#include <stdio.h>
+
+using namespace std;
+using namespace cv;
+using namespace emat;
+
+/**
+describe a mat, e.g. "32FC1 1080x1920"
+**/
+string describe(const Mat& mat) {
+	const char* depth_names[] = { "8U", "8S", "16U", "16S", "32S", "32F", "64F" };
+	string res = string(depth_names[mat.depth()]) + "C" + to_string(mat.channels()) + " ";
+	for (int i = 0; i < mat.dims; ++i) {
+		res += (i ? "x" : "") + to_string(mat.size[i]);
+	}
+	return res;
+}
+
+int main(int argc, const char** argv)
+{
+	//usage: emat_view <dump or directory of dumps> [window width] [window height]
+	//keys: n / space => next dump, p => previous dump, q / esc => quit, ctrl + wheel => slices of N-D dumps
+	if (argc < 2) {
+		printf("usage: emat_view <.npy / .raw / FileStorage dump or directory> [window width] [window height]\n");
+		return -1;
+	}
+	string win_name = "emat_view";
+	Size win_size(argc > 2 ? atoi(argv[2]) : 960, argc > 3 ? atoi(argv[3]) : 720);
+	vector<string> files;
+	list_dumps(argv[1], files);
+	if (files.size() == 0) {
+		files.emplace_back(argv[1]);
+	}
+	emat::viewer viewer;
+	s_mmap_file maps[2];												//the previous dump stays mapped until the viewer got the next one
+	int map_idx = 0, idx = 0, idx_shown = -1;
+	s_vis_policy policy(COLORMAP_JET, s_vis_range::percentile());		//percentile range is sampled (only sampled pages are read)
+	while (idx_shown < 0 || !viewer.is_win_closed(win_name)) {
+		if (idx != idx_shown) {
+			Mat mat;
+			map_idx ^= 1;
+			s_viewer_text viewer_text;
+			viewer_text.font_thickness = 1;
+			if (!load_dump(files[idx], maps[map_idx], mat)) {
+				printf("can not load %s\n", files[idx].c_str());
+				mat = Mat::zeros(1, 1, CV_8U);
+				viewer_text.text = to_string(idx + 1) + " / " + to_string(files.size()) + " " + files[idx] + " (not loaded)";
+			}
+			else {
+				viewer_text.text = to_string(idx + 1) + " / " + to_string(files.size()) + " " + files[idx] + " " + describe(mat);
+			}
+			if (mat.dims > 2 && mat.channels() == 1) {
+				viewer.img_show_cache_stack(win_name, win_size, mat, policy, { viewer_text });
+			}
+			else if (mat.dims > 2) {
+				//N-D multi channel: first plane of all channels
+				vector<Mat> slices;
+				nd_slices(mat, slices);
+				Mat plane;
+				extractChannel(slices.front(), plane, 0);
+				viewer.img_show_cache(win_name, win_size, plane, policy, { viewer_text });
+			}
+			else if (mat.type() == CV_8UC3) {
+				viewer.img_show_cache_shared(win_name, win_size, mat, mat, { viewer_text });
+			}
+			else if (mat.channels() == 1) {
+				viewer.img_show_cache_shared(win_name, win_size, mat, policy, { viewer_text });
+			}
+			else {
+				//other multi channel types: first channel (copied)
+				Mat plane;
+				extractChannel(mat, plane, 0);
+				viewer.img_show_cache(win_name, win_size, plane, policy, { viewer_text });
+			}
+			viewer.imgs_show(true);
+			maps[map_idx ^ 1].close();
+			idx_shown = idx;
+		}
+		int key = waitKey(30);
+		viewer.flush_events();
+		if (key == 'q' || key == 27) break;
+		if (key == 'n' || key == ' ') idx = min(idx + 1, (int)files.size() - 1);
+		if (key == 'p') idx = max(idx - 1, 0);
+	}
+	viewer.destroy_all();
+	return 0;
+}
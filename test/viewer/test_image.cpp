@@ -16,13 +16,24 @@ int main(int argc, const char** argv)
 	viewer_text_1.text = win_name_1;
 	viewer_text_2.text = win_name_2;
 	Mat img = emat::range<i32>(0, 1, Size(160, 120));					//Generate a mat
+	{
+		//a 1-row signal (e.g. a 1-D .npy) gets a percentile range from its samples
+		s_vis_range range = s_vis_range::percentile();
+		Mat signal = emat::range<float>(0, 1, Size(100000, 1));
+		vis_range_update(signal, range);
+		CV_Assert(range.m_valid && range.m_min < range.m_max);
+	}
+	s_mosaic mosaic_colored, mosaic_raw;								//kept across frames, only changed tiles are rendered again
+	bool img_changed = true;
 	while (!viewer.is_win_closed(win_name_1) && !viewer.is_win_closed(win_name_2)) {
+		vector<bool> changed(2, img_changed);
+		img_changed = false;
 		//Update Window 1
 		viewer.img_show_cache(
 			win_name_1,													//Window Name
 			Size(320, 480),												//Window Size
-			vis_gconcat({ vis_gray(img), vis_colormap_jet(img) }, 1),	//combine two images
-			vis_gconcat({ img, img }, 1),								//combine two images
+			vis_gconcat({ vis_gray(img), vis_colormap_jet(img) }, 1, mosaic_colored, changed),	//combine two images
+			vis_gconcat({ img, img }, 1, mosaic_raw, changed),			//combine two images
 			{ viewer_text_1 });											//Texts(Subtitles)
 		//Update Window 2						
 		viewer.img_show_cache(
@@ -1,6 +1,7 @@
 #include <opencv2/opencv.hpp>
 #include <opencv2/core.hpp>
 #include "../../src/eunit/emat/emat_viewer.hpp"
+#include "../../src/eunit/emat/emat_capture.hpp"
 
 using namespace std;
 using namespace cv;
@@ -10,16 +11,23 @@ int main(int argc, const char** argv)
 {
 	string win_name = "Demo";
 	emat::viewer viewer;
-	cv::VideoCapture capture(0);
+	s_capture capture(4, s_capture::policy_drop_oldest);				//Grab on background thread, never throttled by viewer
+	if (!capture.start(0)) {
+		return -1;
+	}
 	s_viewer_text viewer_text;
 	viewer_text.text = win_name;
-	Mat frame;
+	const s_capture::s_frame* frame;
 	while (!viewer.is_win_closed(win_name)) {
-		//Get Captured Frame
-		capture >> frame;
-		//Update Window
-		viewer.img_show_cache(win_name, frame, frame, { viewer_text });
+		//Get Captured Frame (waits for next frame)
+		if (!capture.retrieve(frame, 1000)) {
+			if (capture.finished()) break;
+			continue;
+		}
+		//Update Window (frame is referenced, not copied)
+		viewer.img_show_cache_shared(win_name, frame->mat.size(), frame->mat, frame->mat, { viewer_text });
 		viewer.imgs_show(false);
-		waitKey(10);
+		waitKey(1);
 	}
-}
\ No newline at end of file
+	capture.stop();
+}